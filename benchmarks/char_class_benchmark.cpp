@@ -0,0 +1,122 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <locale>
+#include <set>
+#include <string>
+#include <string_view>
+#include <skyr/details/char_class.hpp>
+
+// Compares the per-byte predicates used by the parser, written with
+// `<locale>` functions, linear searches and `std::set`, against the
+// constexpr character-class table.
+
+namespace {
+namespace char_class = skyr::details::char_class;
+using skyr::details::is_in_class;
+
+bool is_in(char byte, std::string_view view) {
+  return std::find(begin(view), end(view), byte) != end(view);
+}
+
+/// Bytes with roughly the distribution found in URLs, with some
+/// control characters and non-ASCII bytes
+std::string make_input(std::size_t length) {
+  static const auto alphabet =
+      std::string("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789") +
+      std::string("/.:-_?=&%#@~+ \t\x01\x7f\xc3\xa9");
+  auto input = std::string{};
+  auto seed = 12345U;
+  for (auto i = 0U; i < length; ++i) {
+    seed = (seed * 1103515245U) + 12345U;
+    input += alphabet[(seed >> 16) % alphabet.size()];
+  }
+  return input;
+}
+
+template <class Predicate>
+double measure(const std::string &input, std::size_t iterations, Predicate predicate, std::size_t &count) {
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0UL; i < iterations; ++i) {
+    count += static_cast<std::size_t>(std::count_if(begin(input), end(input), predicate));
+  }
+  auto finish = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration<double, std::nano>(finish - start).count();
+  return elapsed / (static_cast<double>(iterations) * input.size());
+}
+
+/// Measures a predicate before and after the change, with both
+/// versions inlined into the loop
+template <class Before, class After>
+void compare(
+    const char *name, const std::string &input, std::size_t iterations,
+    Before before, After after, std::size_t &count) {
+  auto before_time = measure(input, iterations, before, count);
+  auto after_time = measure(input, iterations, after, count);
+  std::cout << std::setw(45) << std::left << name
+            << std::setw(10) << std::right << std::fixed << std::setprecision(2) << before_time
+            << std::setw(10) << std::right << after_time
+            << std::setw(9) << std::right << std::setprecision(1) << (before_time / after_time) << "x"
+            << std::endl;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  auto iterations = (argc > 1)? static_cast<std::size_t>(std::atol(argv[1])) : std::size_t(100);
+  auto input = make_input(std::size_t(1) << 16);
+  const auto &classic = std::locale::classic();
+  const auto path_set = std::set<char>{0x20, 0x22, 0x3c, 0x3e, 0x60, 0x23, 0x3f, 0x7b, 0x7d};
+
+  std::cout << std::setw(45) << std::left << "ns/byte"
+            << std::setw(10) << std::right << "before"
+            << std::setw(10) << std::right << "after"
+            << std::setw(10) << std::right << "speedup" << std::endl;
+
+  auto count = std::size_t{0};
+  compare(
+      "alpha (std::isalpha)", input, iterations,
+      [&classic](char byte) { return std::isalpha(byte, classic); },
+      [](char byte) { return is_in_class(byte, char_class::alpha); }, count);
+  compare(
+      "digit (std::isdigit)", input, iterations,
+      [&classic](char byte) { return std::isdigit(byte, classic); },
+      [](char byte) { return is_in_class(byte, char_class::digit); }, count);
+  compare(
+      "hex digit (std::isxdigit)", input, iterations,
+      [&classic](char byte) { return std::isxdigit(byte, classic); },
+      [](char byte) { return is_in_class(byte, char_class::hex_digit); }, count);
+  compare(
+      "lowercase (std::tolower)", input, iterations,
+      [&classic](char byte) { return std::tolower(byte, classic) == 'a'; },
+      [](char byte) { return skyr::details::to_ascii_lower(byte) == 'a'; }, count);
+  compare(
+      "scheme (std::isalnum, is_in)", input, iterations,
+      [&classic](char byte) { return std::isalnum(byte, classic) || is_in(byte, "+-."); },
+      [](char byte) { return is_in_class(byte, char_class::scheme); }, count);
+  compare(
+      "URL code point (std::isalnum, is_in)", input, iterations,
+      [&classic](char byte) { return std::isalnum(byte, classic) || is_in(byte, "!$&'()*+,-./:=?@_~"); },
+      [](char byte) { return is_in_class(byte, char_class::url_code_point); }, count);
+  compare(
+      "forbidden host (std::find)", input, iterations,
+      [](char byte) { return is_in(byte, std::string_view("\0\t\n\r #%/:?@[\\]", 14)); },
+      [](char byte) { return is_in_class(byte, char_class::forbidden_host); }, count);
+  compare(
+      "C0 control or space (std::isspace, is_in)", input, iterations,
+      [&classic](char byte) {
+        return std::isspace(byte, classic) || is_in(byte, std::string_view("\0\x1b\x04\x12\x1f", 5));
+      },
+      [](char byte) { return is_in_class(byte, char_class::c0_control_or_space); }, count);
+  compare(
+      "path percent-encode set (std::set)", input, iterations,
+      [&path_set](char byte) { return (byte <= 0x1f) || (byte > 0x7e) || (path_set.count(byte) != 0); },
+      [](char byte) { return is_in_class(byte, char_class::path_percent_encode); }, count);
+  return (count == 0)? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <skyr/url_parse.hpp>
+#include <skyr/domain.hpp>
+#include <skyr/unicode.hpp>
+
+// Measures `skyr::parse` on crafted inputs that target the parts of
+// the parser that rewind, buffer or rescan input, at increasing
+// lengths. The parser is linear in the length of its input, so the
+// time per byte for each input should stay about the same as the
+// input grows.
+
+namespace {
+std::string repeat(const std::string &value, std::size_t length) {
+  auto result = std::string{};
+  while (result.size() < length) {
+    result += value;
+  }
+  return result;
+}
+
+std::string non_ascii_label(std::size_t length) {
+  auto label = std::u32string{};
+  for (auto i = 0U; label.size() < length / 3; ++i) {
+    label += static_cast<char32_t>(0x4e00 + ((i * 7919U) % 20000U));
+  }
+  return skyr::utf32_to_bytes(label).value();
+}
+
+struct adversarial_input {
+  const char *name;
+  std::function<std::string (std::size_t)> make;
+  std::function<bool (const std::string &)> parse;
+};
+
+bool parse(const std::string &input) {
+  return static_cast<bool>(skyr::parse(input));
+}
+
+const std::vector<adversarial_input> &adversarial_inputs() {
+  static const auto inputs = std::vector<adversarial_input>{
+    {"many '@' in the authority", [](auto length) {
+      return "http://" + repeat("a:b@", length) + "example.com/";
+    }, parse},
+    {"many ':' in the userinfo", [](auto length) {
+      return "http://" + repeat("a:", length) + "@example.com/";
+    }, parse},
+    {"long non-ASCII host label", [](auto length) {
+      return "http://" + non_ascii_label(length) + "/";
+    }, parse},
+    {"long punycode label (skyr::punycode_decode)", [](auto length) {
+      return skyr::punycode_encode(non_ascii_label(length)).value();
+    }, [](const std::string &input) {
+      return static_cast<bool>(skyr::punycode_decode(input));
+    }},
+    {"many dots in the host", [](auto length) {
+      return "http://" + repeat("1.", length) + "/";
+    }, parse},
+    {"long port", [](auto length) {
+      return "http://example.com:" + repeat("0", length) + "/";
+    }, parse},
+    {"leading and trailing whitespace", [](auto length) {
+      return repeat(" ", length / 2) + "http://example.com/" + repeat(" ", length / 2);
+    }, parse},
+    {"tabs and newlines", [](auto length) {
+      return "http://example.com/" + repeat("a\t\n", length);
+    }, parse},
+    {"many dot segments", [](auto length) {
+      return "http://example.com/" + repeat("a/../", length);
+    }, parse},
+    {"many percent signs", [](auto length) {
+      return "mailto:" + repeat("%", length);
+    }, parse},
+  };
+  return inputs;
+}
+
+double measure(const adversarial_input &input, std::size_t length) {
+  auto value = input.make(length);
+  auto iterations = std::max<std::size_t>(1, (std::size_t(1) << 22) / value.size());
+
+  auto parsed = std::size_t{0};
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0UL; i < iterations; ++i) {
+    if (input.parse(value)) {
+      ++parsed;
+    }
+  }
+  auto finish = std::chrono::steady_clock::now();
+
+  auto elapsed = std::chrono::duration<double, std::nano>(finish - start).count();
+  return elapsed / (static_cast<double>(iterations) * value.size());
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  auto max_length = (argc > 1)? static_cast<std::size_t>(std::atol(argv[1])) : std::size_t(1) << 16;
+
+  auto lengths = std::vector<std::size_t>{};
+  for (auto length = std::size_t(1) << 10; length <= max_length; length <<= 2) {
+    lengths.push_back(length);
+  }
+
+  std::cout << std::setw(45) << std::left << "ns/byte";
+  for (auto length : lengths) {
+    std::cout << std::setw(10) << std::right << length;
+  }
+  std::cout << std::endl;
+
+  for (const auto &input : adversarial_inputs()) {
+    std::cout << std::setw(45) << std::left << input.name;
+    for (auto length : lengths) {
+      std::cout << std::setw(10) << std::right << std::fixed << std::setprecision(2)
+                << measure(input, length);
+    }
+    std::cout << std::endl;
+  }
+}
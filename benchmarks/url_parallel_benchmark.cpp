@@ -0,0 +1,99 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <skyr/url_parallel.hpp>
+#include "json.hpp"
+
+// Measures how `skyr::parse_parallel` scales from one thread to
+// every available core, over a corpus made of generated http(s)
+// URLs and the inputs in the web platform test data. The first
+// argument is the number of inputs, and the second is the maximum
+// number of threads.
+
+using json = nlohmann::json;
+
+namespace {
+std::vector<std::string> make_corpus(std::size_t size) {
+  auto corpus = std::vector<std::string>{};
+  corpus.reserve(size);
+
+  std::ifstream fs{"urltestdata.json"};
+  if (!fs) {
+    throw std::runtime_error("Unable to open file: urltestdata.json");
+  }
+
+  json tests;
+  fs >> tests;
+  auto test_inputs = std::vector<std::string>{};
+  for (auto &&object : tests) {
+    if (!object.is_string()) {
+      test_inputs.push_back(object["input"].get<std::string>());
+    }
+  }
+
+  const char *schemes[] = {"http", "https", "ws", "wss"};
+  for (auto i = 0UL; corpus.size() < size; ++i) {
+    if (i % 16 == 0) {
+      corpus.push_back(test_inputs[(i / 16) % test_inputs.size()]);
+      continue;
+    }
+
+    corpus.push_back(
+        std::string(schemes[i % 4]) + "://host" + std::to_string(i % 1000) +
+        ".example.com/path/" + std::to_string(i) + "/index.html?id=" +
+        std::to_string(i * 7) + "&page=" + std::to_string(i % 50));
+  }
+  return corpus;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  auto size = (argc > 1)? std::strtoul(argv[1], nullptr, 10) : 1000000UL;
+  auto max_threads = (argc > 2)?
+      static_cast<unsigned>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+  max_threads = std::max(max_threads, 1U);
+
+  auto corpus = make_corpus(size);
+  auto inputs = std::vector<std::string_view>(corpus.begin(), corpus.end());
+
+  auto baseline = 0.0;
+  for (auto threads = 1U; threads <= max_threads; threads *= 2) {
+    auto options = skyr::parallel_parse_options{};
+    options.thread_count = threads;
+
+    auto start = std::chrono::steady_clock::now();
+    auto batch = skyr::parse_parallel(inputs, skyr::nullopt, options);
+    auto finish = std::chrono::steady_clock::now();
+
+    auto parsed = std::size_t{0};
+    for (const auto &result : batch) {
+      if (result) {
+        ++parsed;
+      }
+    }
+
+    auto elapsed = std::chrono::duration<double>(finish - start).count();
+    if (threads == 1) {
+      baseline = elapsed;
+    }
+    std::cout << threads << " thread(s): " << inputs.size() << " inputs, "
+              << (elapsed * 1000.0) << " ms, "
+              << (inputs.size() / elapsed / 1e6) << " M URLs/s, "
+              << "speedup " << (baseline / elapsed) << "x ("
+              << parsed << " parsed)" << std::endl;
+
+    if ((threads < max_threads) && (threads * 2 > max_threads)) {
+      threads = max_threads / 2;
+    }
+  }
+}
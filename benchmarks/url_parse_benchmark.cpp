@@ -0,0 +1,403 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <skyr/url.hpp>
+#include <skyr/url_parse.hpp>
+#include <skyr/compact_url_record.hpp>
+#include <skyr/url_view.hpp>
+#include <skyr/url_batch.hpp>
+#include <skyr/url_request_target.hpp>
+#include <skyr/url_authority.hpp>
+#include <skyr/url_stream_parser.hpp>
+#include <skyr/url_parser.hpp>
+#include <skyr/static_url.hpp>
+#include "url_parse_impl.hpp"
+#include "url_sanitize.hpp"
+#include "json.hpp"
+
+// Measures `skyr::parse` over every input in the web platform test
+// data, resolved against its base URL, and over a set of typical
+// http(s) URLs, with and without the ASCII fast path.
+
+using json = nlohmann::json;
+
+namespace {
+struct benchmark_input {
+  std::string input;
+  skyr::optional<skyr::url_record> base;
+};
+
+std::vector<benchmark_input> load_inputs(const std::string &filename) {
+  std::ifstream fs{filename};
+  if (!fs) {
+    throw std::runtime_error("Unable to open file: " + filename);
+  }
+
+  json tests;
+  fs >> tests;
+
+  auto inputs = std::vector<benchmark_input>{};
+  for (auto &&object : tests) {
+    if (object.is_string()) {
+      continue;
+    }
+
+    auto input = benchmark_input{object["input"].get<std::string>(), skyr::nullopt};
+    auto base = skyr::parse(object["base"].get<std::string>());
+    if (base) {
+      input.base = std::move(base.value());
+    }
+    inputs.push_back(std::move(input));
+  }
+  return inputs;
+}
+
+const std::vector<std::string> &typical_urls() {
+  static const auto urls = std::vector<std::string>{
+    "http://example.com/",
+    "https://www.example.com/index.html",
+    "https://api.example.com/v1/users/12345/orders?page=2&per_page=50",
+    "http://cdn.example.net/static/js/app.min.js?v=1.2.3",
+    "https://shop.example.org/products/widget-42#reviews",
+    "https://example.com:8443/health",
+    "wss://stream.example.com/socket?token=abc123",
+    "https://search.example.com/search?q=url+parsing&lang=en&safe=off",
+  };
+  return urls;
+}
+
+const std::vector<std::string> &long_query_urls() {
+  static const auto urls = [] {
+    auto query = std::string{};
+    for (auto i = 0; i < 64; ++i) {
+      query += "utm_param_" + std::to_string(i) + "=some-tracking-value-" + std::to_string(i) + "&";
+    }
+    return std::vector<std::string>{
+      "http://tracker.example.com/collect?" + query,
+      "http://tracker.example.com/collect?" + query + "#" + query,
+    };
+  }();
+  return urls;
+}
+
+/// URLs with deep paths, some of them with dot segments to remove
+const std::vector<std::string> &deep_path_urls() {
+  static const auto urls = std::vector<std::string>{
+    "https://repo.example.com/org/project/blob/main/src/lib/module/sub/detail/impl/file.cpp",
+    "https://docs.example.com/v2/en/latest/reference/api/types/collections/maps/ordered/index.html",
+    "http://files.example.net/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/",
+    "http://files.example.net/a/b/c/./d/e/../f/g/h/./i/j/../../k/l/m/n/o/p",
+    "https://cdn.example.org/assets/2018/10/16/images/thumbnails/large/retina/photo.jpg?w=640",
+    "https://example.com/%7Euser/projects/url/../url-parser/src/./lib/detail/file.hpp",
+  };
+  return urls;
+}
+
+/// The long query URLs as they might arrive from a form or a log
+/// line, with surrounding whitespace and a line break in the query
+const std::vector<std::string> &untidy_long_query_urls() {
+  static const auto urls = [] {
+    auto urls = std::vector<std::string>{};
+    for (const auto &url : long_query_urls()) {
+      auto untidy = "  " + url + "\r\n";
+      untidy.insert(untidy.size() / 2, "\n\t");
+      urls.push_back(untidy);
+    }
+    return urls;
+  }();
+  return urls;
+}
+
+const std::vector<std::string> &request_targets() {
+  static const auto targets = std::vector<std::string>{
+    "/",
+    "/index.html",
+    "/v1/users/12345/orders?page=2&per_page=50",
+    "/static/js/app.min.js?v=1.2.3",
+    "/products/widget-42",
+    "/health",
+    "/socket?token=abc123",
+    "/search?q=url+parsing&lang=en&safe=off",
+  };
+  return targets;
+}
+
+const std::vector<std::string> &host_headers() {
+  static const auto hosts = std::vector<std::string>{
+    "example.com",
+    "www.example.com:8080",
+    "api.example.com",
+    "cdn.example.net:443",
+    "shop.example.org",
+    "stream.example.com:8443",
+    "127.0.0.1:8080",
+    "[::1]:8080",
+  };
+  return hosts;
+}
+
+template <class Parse>
+void measure(
+    const char *name, const std::vector<std::string> &urls, int iterations, Parse parse) {
+  auto parsed = std::size_t{0};
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < iterations; ++i) {
+    for (const auto &input : urls) {
+      if (parse(input)) {
+        ++parsed;
+      }
+    }
+  }
+  auto finish = std::chrono::steady_clock::now();
+
+  auto elapsed = std::chrono::duration<double, std::nano>(finish - start).count();
+  auto count = static_cast<double>(iterations) * urls.size();
+  std::cout << name << ": " << urls.size() << " inputs x "
+            << iterations << " iterations, "
+            << (elapsed / count) << " ns/parse ("
+            << parsed << " parsed)" << std::endl;
+}
+
+template <class Parse>
+void measure_corpus(
+    const char *name, const std::vector<benchmark_input> &inputs, int iterations, Parse parse) {
+  auto parsed = std::size_t{0};
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < iterations; ++i) {
+    for (const auto &input : inputs) {
+      if (parse(input)) {
+        ++parsed;
+      }
+    }
+  }
+  auto finish = std::chrono::steady_clock::now();
+
+  auto elapsed = std::chrono::duration<double, std::nano>(finish - start).count();
+  auto count = static_cast<double>(iterations) * inputs.size();
+  std::cout << name << ": " << inputs.size() << " inputs x "
+            << iterations << " iterations, "
+            << (elapsed / count) << " ns/parse ("
+            << parsed << " parsed)" << std::endl;
+}
+
+void measure_batch(const std::vector<std::string> &urls, int iterations) {
+  auto inputs = std::vector<std::string_view>{};
+  for (auto i = 0; i < iterations; ++i) {
+    inputs.insert(inputs.end(), urls.begin(), urls.end());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto batch = skyr::parse_batch(inputs);
+  auto finish = std::chrono::steady_clock::now();
+
+  auto parsed = std::size_t{0};
+  for (const auto &result : batch) {
+    if (result) {
+      ++parsed;
+    }
+  }
+
+  auto elapsed = std::chrono::duration<double, std::nano>(finish - start).count();
+  std::cout << "typical URLs (skyr::parse_batch): " << urls.size() << " inputs x "
+            << iterations << " iterations, "
+            << (elapsed / inputs.size()) << " ns/parse ("
+            << parsed << " parsed)" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  auto iterations = (argc > 1)? std::atoi(argv[1]) : 200;
+  auto inputs = load_inputs("urltestdata.json");
+
+  measure_corpus("urltestdata.json", inputs, iterations, [](const auto &input) {
+    return static_cast<bool>(skyr::parse(input.input, input.base));
+  });
+  measure_corpus("urltestdata.json (skyr::is_valid_url)", inputs, iterations, [](const auto &input) {
+    return skyr::is_valid_url(input.input, input.base);
+  });
+  measure_corpus("urltestdata.json (skyr::ignore_validation_errors)", inputs, iterations, [](const auto &input) {
+    return static_cast<bool>(skyr::parse(input.input, skyr::ignore_validation_errors{}, input.base));
+  });
+  measure_corpus("urltestdata.json (skyr::fail_on_validation_error)", inputs, iterations, [](const auto &input) {
+    return static_cast<bool>(skyr::parse(input.input, skyr::fail_on_validation_error{}, input.base));
+  });
+  measure_corpus("urltestdata.json (skyr::collect_validation_errors)", inputs, iterations, [](const auto &input) {
+    auto policy = skyr::collect_validation_errors{};
+    return static_cast<bool>(skyr::parse(input.input, policy, input.base));
+  });
+
+  auto parse = [](const auto &input) {
+    return static_cast<bool>(skyr::parse(input));
+  };
+  auto basic_parse = [](const auto &input) {
+    return static_cast<bool>(skyr::details::basic_parse(input));
+  };
+  auto parse_compact = [](const auto &input) {
+    return static_cast<bool>(skyr::parse_compact(input));
+  };
+  auto make_url_view = [](const auto &input) {
+    return static_cast<bool>(skyr::make_url_view(input));
+  };
+  auto is_valid_url = [](const auto &input) {
+    return skyr::is_valid_url(input);
+  };
+  auto parse_until_host = [](const auto &input) {
+    return static_cast<bool>(skyr::parse_until(input, skyr::url_component::host));
+  };
+  auto host = std::string("www.example.com:8080");
+  auto base = skyr::parse("http://" + host).value();
+  auto parse_request_target = [&host](const auto &input) {
+    return static_cast<bool>(skyr::parse_request_target(input, host));
+  };
+  auto parse_with_base = [&base](const auto &input) {
+    return static_cast<bool>(skyr::parse(input, base));
+  };
+  auto parse_concatenated = [&host](const auto &input) {
+    return static_cast<bool>(skyr::parse("http://" + host + input));
+  };
+  measure("request targets (skyr::parse_request_target)", request_targets(), iterations * 10, parse_request_target);
+  measure("request targets (skyr::parse with a base URL)", request_targets(), iterations * 10, parse_with_base);
+  measure("request targets (skyr::parse concatenated)", request_targets(), iterations * 10, parse_concatenated);
+  auto parse_authority = [](const auto &input) {
+    return static_cast<bool>(skyr::parse_authority(input));
+  };
+  auto split_authority = [](const auto &input) {
+    auto view = std::string_view(input);
+    auto separator = view.rfind(':');
+    auto host = std::string(view.substr(0, separator));
+    return !host.empty();
+  };
+  measure("Host headers (skyr::parse_authority)", host_headers(), iterations * 10, parse_authority);
+  measure("Host headers (split on ':')", host_headers(), iterations * 10, split_authority);
+  // The two halves of a URL that wraps around the end of a ring buffer
+  auto parse_segments = [](const auto &input) {
+    auto view = std::string_view(input);
+    auto segments = {view.substr(0, view.size() / 2), view.substr(view.size() / 2)};
+    return static_cast<bool>(skyr::parse_segments(segments));
+  };
+  auto parse_linearized = [](const auto &input) {
+    auto view = std::string_view(input);
+    auto linear = std::string(view.substr(0, view.size() / 2));
+    linear.append(view.substr(view.size() / 2));
+    return static_cast<bool>(skyr::parse(linear));
+  };
+  measure("split URLs (skyr::parse_segments)", typical_urls(), iterations * 10, parse_segments);
+  measure("split URLs (linearized)", typical_urls(), iterations * 10, parse_linearized);
+  measure("split long query URLs (skyr::parse_segments)", long_query_urls(), iterations * 10, parse_segments);
+  measure("split long query URLs (linearized)", long_query_urls(), iterations * 10, parse_linearized);
+  auto parser = skyr::url_parser{};
+  auto reuse_parser = [&parser](const auto &input) {
+    return static_cast<bool>(parser.parse(input));
+  };
+  // The sanitization that used to run before parsing: trimming each
+  // end, then finding and removing tabs and newlines a byte at a time
+  auto sanitize_scalar = [](const auto &input) {
+    auto view = std::string_view(input);
+    skyr::remove_leading_whitespace(view);
+    skyr::remove_trailing_whitespace(view);
+    auto is_tab_or_newline = [](char byte) {
+      return (byte == '\t') || (byte == '\r') || (byte == '\n');
+    };
+    auto it = std::find_if(begin(view), end(view), is_tab_or_newline);
+    if (it == end(view)) {
+      return !view.empty();
+    }
+    auto storage = std::string(begin(view), it);
+    std::remove_copy_if(it, end(view), std::back_inserter(storage), is_tab_or_newline);
+    return !storage.empty();
+  };
+  auto storage = std::string{};
+  auto sanitize_input = [&storage](const auto &input) {
+    return !skyr::details::sanitize_input(input, storage).view.empty();
+  };
+  measure("long query URLs sanitized (scalar)", long_query_urls(), iterations * 100, sanitize_scalar);
+  measure("long query URLs sanitized (skyr::details::sanitize_input)", long_query_urls(), iterations * 100, sanitize_input);
+  measure("untidy long query URLs sanitized (scalar)", untidy_long_query_urls(), iterations * 100, sanitize_scalar);
+  measure("untidy long query URLs sanitized (skyr::details::sanitize_input)", untidy_long_query_urls(), iterations * 100, sanitize_input);
+  measure("untidy long query URLs (skyr::parse)", untidy_long_query_urls(), iterations * 10, parse);
+  measure("typical URLs (skyr::parse)", typical_urls(), iterations * 10, parse);
+  measure("typical URLs (skyr::url_parser)", typical_urls(), iterations * 10, reuse_parser);
+  // The run-time cost of a static_url that isn't declared constexpr
+  auto make_static_url = [](const auto &input) {
+    try {
+      return !skyr::static_url(input).host().empty();
+    }
+    catch (const skyr::url_parse_error &) {
+      return false;
+    }
+  };
+  measure("typical URLs (skyr::static_url)", typical_urls(), iterations * 10, make_static_url);
+  measure("deep path URLs (skyr::parse)", deep_path_urls(), iterations * 10, parse);
+  measure("deep path URLs (skyr::url_parser)", deep_path_urls(), iterations * 10, reuse_parser);
+  measure("deep path URLs (state machine)", deep_path_urls(), iterations * 10, basic_parse);
+  measure("long query URLs (skyr::parse)", long_query_urls(), iterations * 10, parse);
+  // Setters only reserialize the section of the href they change, so
+  // the long query isn't copied when the port or fragment is set
+  auto long_query_instances = std::vector<skyr::url>();
+  for (const auto &input : long_query_urls()) {
+    long_query_instances.emplace_back(input);
+  }
+  auto next_instance = std::size_t{0};
+  auto set_components = [&](const auto &) {
+    auto &instance = long_query_instances[next_instance++ % long_query_instances.size()];
+    return instance.set_port("8080") && instance.set_hash("section") &&
+        instance.set_username("user") && instance.set_port("81") && instance.set_hash("top");
+  };
+  measure("long query URLs (five skyr::url setters)", long_query_urls(), iterations * 10, set_components);
+  // A redirect that moves the host, path and query together, with
+  // three setters and with one transaction
+  auto typical_instances = std::vector<skyr::url>();
+  for (const auto &input : typical_urls()) {
+    typical_instances.emplace_back(input);
+  }
+  auto next_typical = std::size_t{0};
+  auto redirect_with_setters = [&](const auto &) {
+    auto &instance = typical_instances[next_typical++ % typical_instances.size()];
+    return instance.set_host("example.org") && instance.set_pathname("/moved") &&
+        instance.set_search("from=redirect");
+  };
+  auto redirect_with_modify = [&](const auto &) {
+    auto &instance = typical_instances[next_typical++ % typical_instances.size()];
+    return instance.modify([](skyr::url_editor &editor) {
+      editor.host("example.org");
+      editor.pathname("/moved");
+      editor.search("from=redirect");
+    }).has_value();
+  };
+  measure("typical URLs (three skyr::url setters)", typical_urls(), iterations * 10, redirect_with_setters);
+  measure("typical URLs (skyr::url::modify)", typical_urls(), iterations * 10, redirect_with_modify);
+  // An access log reads a few components of each URL
+  auto log_with_getters = [&](const auto &) {
+    const auto &instance = typical_instances[next_typical++ % typical_instances.size()];
+    return (instance.protocol().size() + instance.host().size() + instance.pathname().size() +
+            instance.search().size() + instance.hash().size()) != 0;
+  };
+  auto log_with_views = [&](const auto &) {
+    const auto &instance = typical_instances[next_typical++ % typical_instances.size()];
+    return (instance.protocol_view().size() + instance.host_view().size() +
+            instance.pathname_view().size() + instance.search_view().size() +
+            instance.hash_view().size()) != 0;
+  };
+  measure("typical URLs (five skyr::url getters)", typical_urls(), iterations * 100, log_with_getters);
+  measure("typical URLs (five skyr::url views)", typical_urls(), iterations * 100, log_with_views);
+  measure("long query URLs (skyr::url_parser)", long_query_urls(), iterations * 10, reuse_parser);
+  measure("typical URLs (skyr::parse_compact)", typical_urls(), iterations * 10, parse_compact);
+  measure("typical URLs (skyr::make_url_view)", typical_urls(), iterations * 10, make_url_view);
+  measure_batch(typical_urls(), iterations * 10);
+  measure("typical URLs (state machine)", typical_urls(), iterations * 10, basic_parse);
+  measure("typical URLs (skyr::parse_until host)", typical_urls(), iterations * 10, parse_until_host);
+  measure("long query URLs (state machine)", long_query_urls(), iterations * 10, basic_parse);
+  measure("long query URLs (skyr::is_valid_url)", long_query_urls(), iterations * 10, is_valid_url);
+  measure("typical URLs (skyr::is_valid_url)", typical_urls(), iterations * 10, is_valid_url);
+  measure("long query URLs (skyr::parse_until host)", long_query_urls(), iterations * 10, parse_until_host);
+}
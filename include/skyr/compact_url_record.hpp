@@ -0,0 +1,163 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_COMPACT_URL_RECORD_INC
+#define SKYR_COMPACT_URL_RECORD_INC
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <skyr/optional.hpp>
+#include <skyr/expected.hpp>
+#include <skyr/url_record.hpp>
+#include <skyr/details/url_components.hpp>
+
+namespace skyr {
+/// Represents the parts of a URL identifier using a single buffer
+///
+/// The serialized URL is held in one string, and each component is
+/// a range inside it. Compared with a `url_record`, this needs one
+/// heap allocation instead of one per component and path segment,
+/// and the serialized URL is available without any extra work.
+class compact_url_record {
+
+ public:
+
+  /// ASCII string type
+  using string_type = std::string;
+  /// A view into the serialized URL
+  using string_view = std::string_view;
+
+  /// A forward iterator over the path segments
+  using path_iterator = details::url_path_iterator;
+
+  /// Constructs an empty record
+  compact_url_record();
+
+  /// Serializes an existing `url_record`
+  ///
+  /// \param record A URL record
+  explicit compact_url_record(const url_record &record);
+
+  /// \returns The serialized URL
+  string_view href() const noexcept {
+    return href_;
+  }
+
+  /// \returns The URL scheme, without the trailing `":"`
+  string_view scheme() const noexcept {
+    return view(components::scheme_index);
+  }
+
+  /// \returns The URL username
+  string_view username() const noexcept {
+    return view(components::username_index);
+  }
+
+  /// \returns The URL password
+  string_view password() const noexcept {
+    return view(components::password_index);
+  }
+
+  /// \returns The serialized host, or `nullopt` if there is none
+  optional<string_view> host() const noexcept;
+
+  /// \returns The URL port, or `nullopt` if there is none
+  optional<std::uint16_t> port() const noexcept;
+
+  /// \returns The serialized path, as returned by `url::pathname()`
+  string_view pathname() const noexcept {
+    return view(components::path_index);
+  }
+
+  /// \returns The URL query, without the leading `"?"`, or `nullopt`
+  ///          if there is none
+  optional<string_view> query() const noexcept;
+
+  /// \returns The URL query with a leading `"?"`, or an empty string
+  ///          if the query is empty, as returned by `url::search()`
+  string_view search() const noexcept;
+
+  /// \returns The URL fragment, without the leading `"#"`, or
+  ///          `nullopt` if there is none
+  optional<string_view> fragment() const noexcept;
+
+  /// \returns The URL fragment with a leading `"#"`, or an empty
+  ///          string if the fragment is empty, as returned by
+  ///          `url::hash()`
+  string_view hash() const noexcept;
+
+  /// \returns An iterator to the first path segment
+  path_iterator path_begin() const noexcept {
+    return path_iterator(pathname(), cannot_be_a_base_url());
+  }
+
+  /// \returns An iterator past the last path segment
+  path_iterator path_end() const noexcept {
+    return path_iterator();
+  }
+
+  /// \returns `true` if this URL cannot be used as a base URL
+  bool cannot_be_a_base_url() const noexcept {
+    return components_.has(components::cannot_be_a_base_url_flag);
+  }
+
+  /// \returns `true` if a non-fatal validation error occurred
+  ///          during parsing
+  bool validation_error() const noexcept {
+    return components_.has(components::validation_error_flag);
+  }
+
+  /// \returns `true` if the serialized URL is empty
+  bool empty() const noexcept {
+    return href_.empty();
+  }
+
+  /// \returns A `url_record` with the same components
+  url_record to_record() const;
+
+  /// Swaps two `compact_url_record` objects
+  /// \param other Another `compact_url_record` object
+  void swap(compact_url_record &other) noexcept;
+
+ private:
+
+  friend expected<compact_url_record, std::error_code> parse_compact(
+      std::string_view input, const optional<url_record> &base);
+
+  using components = details::url_components;
+
+  string_view view(std::size_t index) const noexcept {
+    return components_.view(href_, index);
+  }
+
+  string_type href_;
+  components components_;
+};
+
+/// Swaps two `compact_url_record` objects
+///
+/// Equivalent to `lhs.swap(rhs)`
+///
+/// \param lhs A `compact_url_record` object
+/// \param rhs A `compact_url_record` object
+void swap(compact_url_record &lhs, compact_url_record &rhs) noexcept;
+
+/// Parses a URL and returns a `compact_url_record`
+///
+/// Plain ASCII http(s) and ws(s) URLs are serialized straight into
+/// the record's buffer without building a `url_record`.
+///
+/// \param input The input string
+/// \param base An optional base URL
+/// \returns A `compact_url_record` on success and an error code on
+///          failure
+expected<compact_url_record, std::error_code> parse_compact(
+    std::string_view input,
+    const optional<url_record> &base = nullopt);
+}  // namespace skyr
+
+#endif  // SKYR_COMPACT_URL_RECORD_INC
@@ -0,0 +1,154 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_DETAILS_CHAR_CLASS_INC
+#define SKYR_URL_DETAILS_CHAR_CLASS_INC
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace skyr {
+/// \exclude
+namespace details {
+/// The classes of byte used by the parser, as bits in
+/// `char_class_table`
+namespace char_class {
+/// An ASCII letter
+constexpr std::uint32_t alpha = 1u << 0;
+/// An ASCII digit
+constexpr std::uint32_t digit = 1u << 1;
+/// An ASCII hex digit
+constexpr std::uint32_t hex_digit = 1u << 2;
+/// A byte that can follow the first letter of a scheme
+constexpr std::uint32_t scheme = 1u << 3;
+/// An ASCII URL code point
+constexpr std::uint32_t url_code_point = 1u << 4;
+/// A forbidden host code point
+constexpr std::uint32_t forbidden_host = 1u << 5;
+/// A byte that is trimmed from the start and end of the input
+constexpr std::uint32_t c0_control_or_space = 1u << 6;
+/// A byte in the C0 control percent-encode set
+constexpr std::uint32_t c0_control_percent_encode = 1u << 7;
+/// A byte in the fragment percent-encode set
+constexpr std::uint32_t fragment_percent_encode = 1u << 8;
+/// A byte in the query percent-encode set
+constexpr std::uint32_t query_percent_encode = 1u << 9;
+/// A byte in the path percent-encode set
+constexpr std::uint32_t path_percent_encode = 1u << 10;
+/// A byte in the userinfo percent-encode set
+constexpr std::uint32_t userinfo_percent_encode = 1u << 11;
+/// A byte of a host accepted by `fast_parse`
+constexpr std::uint32_t fast_host = 1u << 12;
+/// A byte of a path segment accepted by `fast_parse`
+constexpr std::uint32_t fast_path = 1u << 13;
+/// A byte of a query accepted by `fast_parse`
+constexpr std::uint32_t fast_query = 1u << 14;
+/// A byte of a fragment accepted by `fast_parse`
+constexpr std::uint32_t fast_fragment = 1u << 15;
+/// A byte that the query state percent encodes, which for special
+/// URLs also includes `'\''`
+constexpr std::uint32_t query_state_percent_encode = 1u << 16;
+}  // namespace char_class
+
+/// \returns A table of the classes of each byte
+constexpr std::array<std::uint32_t, 256> make_char_class_table() noexcept {
+  auto table = std::array<std::uint32_t, 256>{};
+  auto add = [&table] (std::string_view bytes, std::uint32_t classes) {
+    for (auto byte : bytes) {
+      table[static_cast<unsigned char>(byte)] |= classes;
+    }
+  };
+
+  for (auto i = 0; i < 256; ++i) {
+    auto is_upper = (i >= 'A') && (i <= 'Z');
+    auto is_lower = (i >= 'a') && (i <= 'z');
+    auto is_digit = (i >= '0') && (i <= '9');
+    auto is_printable = (i > 0x20) && (i < 0x7f);
+
+    if (is_upper || is_lower) {
+      table[i] |= char_class::alpha;
+    }
+    if (is_digit) {
+      table[i] |= char_class::digit;
+    }
+    if (is_digit || ((i >= 'a') && (i <= 'f')) || ((i >= 'A') && (i <= 'F'))) {
+      table[i] |= char_class::hex_digit;
+    }
+    if (is_upper || is_lower || is_digit) {
+      table[i] |=
+          char_class::scheme | char_class::url_code_point | char_class::fast_path;
+    }
+    if (is_lower || is_digit) {
+      table[i] |= char_class::fast_host;
+    }
+    if ((i <= 0x1f) || (i > 0x7e)) {
+      table[i] |=
+          char_class::c0_control_percent_encode |
+          char_class::fragment_percent_encode |
+          char_class::query_percent_encode |
+          char_class::path_percent_encode |
+          char_class::userinfo_percent_encode |
+          char_class::query_state_percent_encode;
+    }
+    if (is_printable) {
+      table[i] |= char_class::fast_query | char_class::fast_fragment;
+    }
+  }
+
+  add("+-.", char_class::scheme);
+  add("!$&'()*+,-./:=?@_~", char_class::url_code_point);
+  add(std::string_view("\0\t\n\r #%/:?@[\\]", 14), char_class::forbidden_host);
+  add(std::string_view("\0\x04\t\n\v\f\r\x12\x1b\x1f ", 11), char_class::c0_control_or_space);
+  add(
+      " \"<>`",
+      char_class::fragment_percent_encode |
+      char_class::query_percent_encode |
+      char_class::path_percent_encode |
+      char_class::userinfo_percent_encode);
+  add("'", char_class::query_percent_encode);
+  add(" \"#<>", char_class::query_state_percent_encode);
+  add(
+      "#?{}",
+      char_class::path_percent_encode | char_class::userinfo_percent_encode);
+  add("/:;=@[\\]^|", char_class::userinfo_percent_encode);
+  add("-.", char_class::fast_host);
+  add("!$&'()*+,-.:=@_~", char_class::fast_path);
+
+  for (auto byte : std::string_view("\"<>'")) {
+    table[static_cast<unsigned char>(byte)] &= ~char_class::fast_query;
+  }
+  for (auto byte : std::string_view("\"<>`")) {
+    table[static_cast<unsigned char>(byte)] &= ~char_class::fast_fragment;
+  }
+  return table;
+}
+
+/// The classes of each byte, indexed by its unsigned value
+inline constexpr auto char_class_table = make_char_class_table();
+
+/// \param byte The input byte
+/// \param classes One or more of the bits in `char_class`
+/// \returns `true` if the byte is in any of the classes
+constexpr bool is_in_class(char byte, std::uint32_t classes) noexcept {
+  return (char_class_table[static_cast<unsigned char>(byte)] & classes) != 0;
+}
+
+/// \returns The byte, converted to lowercase if it is an ASCII
+///          uppercase letter
+constexpr char to_ascii_lower(char byte) noexcept {
+  return ((byte >= 'A') && (byte <= 'Z'))? static_cast<char>(byte + ('a' - 'A')) : byte;
+}
+
+/// \returns The value of an ASCII hex digit
+constexpr std::uint16_t hex_digit_value(char byte) noexcept {
+  return
+      ((byte >= '0') && (byte <= '9'))? static_cast<std::uint16_t>(byte - '0') :
+      static_cast<std::uint16_t>(to_ascii_lower(byte) - 'a' + 10);
+}
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_DETAILS_CHAR_CLASS_INC
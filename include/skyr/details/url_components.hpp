@@ -0,0 +1,148 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_DETAILS_URL_COMPONENTS_INC
+#define SKYR_URL_DETAILS_URL_COMPONENTS_INC
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <skyr/optional.hpp>
+
+namespace skyr {
+/// \exclude
+namespace details {
+/// A forward iterator over the path segments of a serialized URL
+class url_path_iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::string_view;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type *;
+  using reference = const value_type &;
+
+  /// Constructs an end iterator
+  url_path_iterator() noexcept = default;
+
+  /// \param path The serialized path, including the leading `"/"`
+  ///        unless the path is opaque
+  /// \param opaque `true` if the path is a single opaque segment
+  url_path_iterator(std::string_view path, bool opaque) noexcept {
+    if (opaque) {
+      segment_ = path;
+      at_end_ = false;
+    }
+    else if (!path.empty()) {
+      remaining_ = path;
+      at_end_ = false;
+      ++(*this);
+    }
+  }
+
+  reference operator * () const noexcept {
+    return segment_;
+  }
+
+  pointer operator -> () const noexcept {
+    return &segment_;
+  }
+
+  url_path_iterator &operator ++ () noexcept {
+    if (remaining_.empty()) {
+      segment_ = std::string_view();
+      at_end_ = true;
+      return *this;
+    }
+
+    remaining_.remove_prefix(1);
+    segment_ = remaining_.substr(0, remaining_.find('/'));
+    remaining_.remove_prefix(segment_.size());
+    return *this;
+  }
+
+  url_path_iterator operator ++ (int) noexcept {
+    auto result = *this;
+    ++(*this);
+    return result;
+  }
+
+  bool operator == (const url_path_iterator &other) const noexcept {
+    return (segment_.data() == other.segment_.data()) && (at_end_ == other.at_end_);
+  }
+
+  bool operator != (const url_path_iterator &other) const noexcept {
+    return !(*this == other);
+  }
+
+ private:
+  std::string_view segment_;
+  std::string_view remaining_;
+  bool at_end_ = true;
+};
+
+/// The positions of each component inside a serialized URL,
+/// excluding the delimiters
+struct url_components {
+  enum : std::size_t {
+    scheme_index = 0,
+    username_index,
+    password_index,
+    host_index,
+    path_index,
+    query_index,
+    fragment_index,
+    component_count,
+  };
+
+  enum : std::uint8_t {
+    has_host_flag = 0x01,
+    has_port_flag = 0x02,
+    has_query_flag = 0x04,
+    has_fragment_flag = 0x08,
+    cannot_be_a_base_url_flag = 0x10,
+    validation_error_flag = 0x20,
+  };
+
+  struct range {
+    std::uint32_t offset;
+    std::uint32_t length;
+  };
+
+  std::array<range, component_count> ranges{};
+  std::uint16_t port = 0;
+  std::uint8_t flags = 0;
+
+  bool has(std::uint8_t flag) const noexcept {
+    return (flags & flag) != 0;
+  }
+
+  std::string_view view(std::string_view href, std::size_t index) const noexcept {
+    return href.substr(ranges[index].offset, ranges[index].length);
+  }
+
+  /// \returns The component with its leading delimiter, or an empty
+  ///          string if the component is empty
+  std::string_view view_with_delimiter(
+      std::string_view href, std::size_t index) const noexcept {
+    if (ranges[index].length == 0) {
+      return {};
+    }
+    return href.substr(ranges[index].offset - 1, ranges[index].length + 1);
+  }
+
+  optional<std::string_view> optional_view(
+      std::string_view href, std::size_t index, std::uint8_t flag) const noexcept {
+    if (!has(flag)) {
+      return nullopt;
+    }
+    return view(href, index);
+  }
+};
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_DETAILS_URL_COMPONENTS_INC
@@ -0,0 +1,226 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_DETAILS_URL_FAST_SCAN_INC
+#define SKYR_URL_DETAILS_URL_FAST_SCAN_INC
+
+#include <cstdint>
+#include <string_view>
+#include <skyr/details/char_class.hpp>
+
+namespace skyr {
+/// \exclude
+namespace details {
+constexpr bool is_lower_alpha(char byte) noexcept {
+  return (byte >= 'a') && (byte <= 'z');
+}
+
+constexpr bool is_digit(char byte) noexcept {
+  return (byte >= '0') && (byte <= '9');
+}
+
+constexpr bool is_host_byte(char byte) noexcept {
+  return is_in_class(byte, char_class::fast_host);
+}
+
+/// URL code points that are left as-is in the path percent-encode set
+constexpr bool is_path_byte(char byte) noexcept {
+  return is_in_class(byte, char_class::fast_path);
+}
+
+constexpr bool is_query_byte(char byte) noexcept {
+  return is_in_class(byte, char_class::fast_query);
+}
+
+constexpr bool is_fragment_byte(char byte) noexcept {
+  return is_in_class(byte, char_class::fast_fragment);
+}
+
+/// The components of a URL in the shape recognised by `fast_parse`,
+/// as views into the input string
+struct fast_url_scan {
+  /// The scheme, without the trailing `":"`
+  std::string_view scheme;
+  /// The host, which is already in its serialized form
+  std::string_view host;
+  /// The port digits as they appear in the input, if any
+  std::string_view port_string;
+  /// The port, if `has_port` is set
+  std::uint16_t port = 0;
+  /// `true` if there is a port that isn't the default port
+  bool has_port = false;
+  /// The path, including the leading `"/"`, or an empty view
+  std::string_view path;
+  /// The query, without the leading `"?"`
+  std::string_view query;
+  /// `true` if there is a query, which may be empty
+  bool has_query = false;
+  /// The fragment, without the leading `"#"`
+  std::string_view fragment;
+  /// `true` if there is a fragment, which may be empty
+  bool has_fragment = false;
+};
+
+/// \returns The scheme at the start of `input` if it is `http`,
+///          `https`, `ws` or `wss` followed by `"://"`, or an empty
+///          view
+constexpr std::string_view scan_fast_scheme(std::string_view input) noexcept {
+  constexpr std::string_view schemes[] = {"http", "https", "ws", "wss"};
+  for (auto scheme : schemes) {
+    if ((input.substr(0, scheme.size()) == scheme) &&
+        (input.substr(scheme.size(), 3) == "://")) {
+      return input.substr(0, scheme.size());
+    }
+  }
+  return {};
+}
+
+/// \returns `true` if `scheme` is `http`, `https`, `ws` or `wss`
+constexpr bool is_fast_scheme(std::string_view scheme) noexcept {
+  return
+      (scheme == "http") || (scheme == "https") ||
+      (scheme == "ws") || (scheme == "wss");
+}
+
+/// \returns The default port of a scheme accepted by `is_fast_scheme`
+constexpr std::uint16_t fast_default_port(std::string_view scheme) noexcept {
+  return ((scheme == "https") || (scheme == "wss"))? 443 : 80;
+}
+
+/// Recognises a host and optional port at the start of `input`, and
+/// removes them from it
+constexpr bool scan_host_and_port(std::string_view &input, fast_url_scan &parts) noexcept {
+  auto it = std::string_view::size_type(0), last = input.size();
+
+  // The host must not be empty, and must have at least one label that
+  // starts with a letter so that it can never be an IPv4 address
+  auto has_alpha_label = false;
+  auto label_start = true;
+  while ((it != last) &&
+         (input[it] != '/') && (input[it] != '?') && (input[it] != '#') && (input[it] != ':')) {
+    if (!is_host_byte(input[it])) {
+      return false;
+    }
+    has_alpha_label |= label_start && is_lower_alpha(input[it]);
+    label_start = (input[it] == '.');
+    ++it;
+  }
+  if ((it == 0) || !has_alpha_label) {
+    return false;
+  }
+  parts.host = input.substr(0, it);
+
+  if ((it != last) && (input[it] == ':')) {
+    ++it;
+    auto port_first = it;
+    auto value = 0UL;
+    while ((it != last) && (input[it] != '/') && (input[it] != '?') && (input[it] != '#')) {
+      if (!is_digit(input[it])) {
+        return false;
+      }
+      value = (value * 10) + (input[it] - '0');
+      if (value >= 65535) {
+        return false;
+      }
+      ++it;
+    }
+    if (it == port_first) {
+      return false;
+    }
+    parts.port_string = input.substr(port_first, it - port_first);
+    if (value != fast_default_port(parts.scheme)) {
+      parts.port = static_cast<std::uint16_t>(value);
+      parts.has_port = true;
+    }
+  }
+
+  input.remove_prefix(it);
+  return true;
+}
+
+/// Recognises the path, query and fragment that make up the rest of
+/// `input`
+constexpr bool scan_path_query_and_fragment(std::string_view input, fast_url_scan &parts) noexcept {
+  auto it = std::string_view::size_type(0), last = input.size();
+
+  if ((it != last) && (input[it] == '/')) {
+    auto segment_first = ++it;
+    while (true) {
+      if ((it == last) || (input[it] == '/') || (input[it] == '?') || (input[it] == '#')) {
+        auto segment = input.substr(segment_first, it - segment_first);
+        if ((segment == ".") || (segment == "..")) {
+          return false;
+        }
+        if ((it == last) || (input[it] != '/')) {
+          break;
+        }
+        segment_first = it + 1;
+      } else if (!is_path_byte(input[it])) {
+        return false;
+      }
+      ++it;
+    }
+    parts.path = input.substr(0, it);
+  }
+
+  if ((it != last) && (input[it] == '?')) {
+    auto query_first = ++it;
+    while ((it != last) && (input[it] != '#')) {
+      if (!is_query_byte(input[it])) {
+        return false;
+      }
+      ++it;
+    }
+    parts.query = input.substr(query_first, it - query_first);
+    parts.has_query = true;
+  }
+
+  if ((it != last) && (input[it] == '#')) {
+    auto fragment_first = ++it;
+    for (; it != last; ++it) {
+      if (!is_fragment_byte(input[it])) {
+        return false;
+      }
+    }
+    parts.fragment = input.substr(fragment_first);
+    parts.has_fragment = true;
+  }
+
+  return true;
+}
+
+/// Recognises the scheme, host and port at the start of a URL in
+/// the shape accepted by `fast_parse`, and removes them from `input`
+///
+/// What is left of `input` is empty or starts with a `'/'`, `'?'`
+/// or `'#'`, and the full parser can't fail on it.
+///
+/// \param input The input string
+/// \param parts Receives the scheme, host and port
+/// \returns `true` if the scheme, host and port have the right shape
+constexpr bool scan_fast_origin(std::string_view &input, fast_url_scan &parts) noexcept {
+  parts.scheme = scan_fast_scheme(input);
+  if (parts.scheme.empty()) {
+    return false;
+  }
+
+  input.remove_prefix(parts.scheme.size() + 3);
+  return scan_host_and_port(input, parts);
+}
+
+/// Recognises a whole URL in the shape accepted by `fast_parse`
+///
+/// \param input The input string
+/// \param parts Receives the URL components
+/// \returns `true` if the input has the right shape
+constexpr bool scan_fast_url(std::string_view input, fast_url_scan &parts) noexcept {
+  return
+      scan_fast_origin(input, parts) &&
+      scan_path_query_and_fragment(input, parts);
+}
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_DETAILS_URL_FAST_SCAN_INC
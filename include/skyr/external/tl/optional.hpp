@@ -368,7 +368,7 @@ template <class T> struct optional_operations_base : optional_storage_base<T> {
       }
     }
 
-    if (rhs.has_value()) {
+    else if (rhs.has_value()) {
       construct(std::forward<Opt>(rhs).get());
     }
   }
@@ -1258,6 +1258,7 @@ public:
 
     *this = nullopt;
     this->construct(std::forward<Args>(args)...);
+    return value();
   }
 
   /// \group emplace
@@ -1269,6 +1270,7 @@ public:
   emplace(std::initializer_list<U> il, Args &&... args) {
     *this = nullopt;
     this->construct(il, std::forward<Args>(args)...);
+    return value();
   }
 
   /// Swaps this optional with the other.
@@ -1280,9 +1282,9 @@ public:
   void
   swap(optional &rhs) noexcept(std::is_nothrow_move_constructible<T>::value
                                    &&detail::is_nothrow_swappable<T>::value) {
+    using std::swap;
     if (has_value()) {
       if (rhs.has_value()) {
-        using std::swap;
         swap(**this, *rhs);
       } else {
         new (std::addressof(rhs.m_value)) T(std::move(this->m_value));
@@ -1292,6 +1294,7 @@ public:
       new (std::addressof(this->m_value)) T(std::move(rhs.m_value));
       rhs.m_value.T::~T();
     }
+    swap(this->m_has_value, rhs.m_has_value);
   }
 
   /// \returns a pointer to the stored value
@@ -9,9 +9,9 @@
 #include <string>
 #include <string_view>
 #include <locale>
-#include <set>
 #include <cstddef>
 #include <skyr/expected.hpp>
+#include <skyr/details/char_class.hpp>
 
 namespace skyr {
 /// Enumerates percent encoding errors
@@ -53,26 +53,19 @@ class c0_control_set : public exclude_set {
 
  private:
   bool contains_impl(char byte) const override {
-    return (byte <= 0x1f) || (byte > 0x7e);
+    return details::is_in_class(byte, details::char_class::c0_control_percent_encode);
   }
 };
 
 /// Defines code points in the fragment percent-encode set
 class fragment_set : public exclude_set {
  public:
-  fragment_set() : set_{0x20, 0x22, 0x3c, 0x3e, 0x60} {}
   virtual ~fragment_set() {}
 
  private:
   bool contains_impl(char byte) const override {
-    return
-        c0_control_set_.contains(byte) ||
-        (set_.find(byte) != set_.end());
+    return details::is_in_class(byte, details::char_class::fragment_percent_encode);
   }
-
- private:
-  c0_control_set c0_control_set_;
-  std::set<char> set_;
 };
 
 /// Defines code points in the fragment percent-encode set and
@@ -83,49 +76,30 @@ class query_set : public exclude_set {
 
  private:
   bool contains_impl(char byte) const override {
-    return
-        fragment_set_.contains(byte) || (byte == 0x27);
+    return details::is_in_class(byte, details::char_class::query_percent_encode);
   }
-
- private:
-  fragment_set fragment_set_;
 };
 
 /// Defines code points in the path percent-encode set
 class path_set : public exclude_set {
  public:
-  path_set() : set_{0x23, 0x3f, 0x7b, 0x7d} {}
   virtual ~path_set() {}
 
  private:
   bool contains_impl(char byte) const override {
-    return
-        fragment_set_.contains(byte) ||
-        (set_.find(byte) != set_.end());
+    return details::is_in_class(byte, details::char_class::path_percent_encode);
   }
-
- private:
-  fragment_set fragment_set_;
-  std::set<char> set_;
 };
 
 /// Defines code points in the userinfo percent-encode set
 class userinfo_set : public exclude_set {
  public:
-  userinfo_set()
-    : set_{0x2f, 0x3a, 0x3b, 0x3d, 0x40, 0x5b, 0x5c, 0x5d, 0x5e, 0x7c} {}
   virtual ~userinfo_set() {}
 
  private:
   bool contains_impl(char byte) const override {
-    return
-        path_set_.contains(byte) ||
-        (set_.find(byte) != set_.end());
+    return details::is_in_class(byte, details::char_class::userinfo_percent_encode);
   }
-
- private:
-  path_set path_set_;
-  std::set<char> set_;
 };
 
 /// Percent encodes a byte if it is not in the exclude set
@@ -168,7 +142,7 @@ expected<std::string, std::error_code> percent_decode(
 
 /// Tests whether the input string contains percent encoded values
 /// \param input An ASCII string
-/// \param locale A locale
+/// \param locale Not used, because hex digits are always ASCII
 /// \returns `true` if the input string contains percent encoded
 ///          values, `false` otherwise
 bool is_percent_encoded(
@@ -0,0 +1,168 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_STATIC_URL_INC
+#define SKYR_STATIC_URL_INC
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <skyr/optional.hpp>
+#include <skyr/url.hpp>
+#include <skyr/url_error.hpp>
+#include <skyr/url_record.hpp>
+#include <skyr/details/url_fast_scan.hpp>
+
+namespace skyr {
+/// A URL that can be parsed and validated at compile time
+///
+/// A `static_url` accepts plain ASCII `http`, `https`, `ws` and `wss`
+/// URLs that are already in their serialized form: a lowercase
+/// domain host, no credentials, a path that starts with `"/"`, no dot
+/// segments, no default port and nothing that needs percent encoding.
+/// For these URLs the WhatWG parser doesn't change the input, so the
+/// components are views into it and a `static_url` never allocates.
+///
+/// A `static_url` declared `constexpr` is parsed by the compiler, and
+/// an invalid or unsupported URL fails the build:
+///
+/// \code
+/// using namespace skyr::literals;
+/// constexpr auto endpoint = "https://api.example.com/v1/users"_url;
+/// static_assert(endpoint.host() == "api.example.com");
+/// \endcode
+///
+/// Otherwise the URL is parsed at run time, and `url_parse_error` is
+/// thrown if it is not supported. Other URLs, such as those with
+/// IDNA hosts or IP addresses, should use `skyr::url`.
+class static_url {
+ public:
+
+  /// A view into the serialized URL
+  using string_view = std::string_view;
+
+  /// Constructor
+  ///
+  /// \param input A URL in serialized form, which must outlive the
+  ///        `static_url`
+  /// \throws url_parse_error if the input is not supported
+  constexpr explicit static_url(string_view input)
+    : href_(input) {
+    if (!details::scan_fast_url(input, parts_) || parts_.path.empty() ||
+        !has_serialized_port()) {
+      throw url_parse_error(make_error_code(url_parse_errc::not_a_static_url));
+    }
+  }
+
+  /// \returns The serialized URL
+  constexpr string_view href() const noexcept {
+    return href_;
+  }
+
+  /// \returns The URL scheme, without the trailing `":"`
+  constexpr string_view scheme() const noexcept {
+    return parts_.scheme;
+  }
+
+  /// \returns The URL scheme with a trailing `":"`, as returned by
+  ///          `url::protocol()`
+  constexpr string_view protocol() const noexcept {
+    return string_view(parts_.scheme.data(), parts_.scheme.size() + 1);
+  }
+
+  /// \returns The serialized host
+  constexpr string_view host() const noexcept {
+    return parts_.host;
+  }
+
+  /// \returns The URL port, or `nullopt` if there is none
+  constexpr optional<std::uint16_t> port() const noexcept {
+    if (!parts_.has_port) {
+      return nullopt;
+    }
+    return parts_.port;
+  }
+
+  /// \returns The serialized path, as returned by `url::pathname()`
+  constexpr string_view pathname() const noexcept {
+    return parts_.path;
+  }
+
+  /// \returns The URL query, without the leading `"?"`, or `nullopt`
+  ///          if there is none
+  constexpr optional<string_view> query() const noexcept {
+    if (!parts_.has_query) {
+      return nullopt;
+    }
+    return parts_.query;
+  }
+
+  /// \returns The URL query with a leading `"?"`, as returned by
+  ///          `url::search()`
+  constexpr string_view search() const noexcept {
+    return with_delimiter(parts_.query);
+  }
+
+  /// \returns The URL fragment, without the leading `"#"`, or
+  ///          `nullopt` if there is none
+  constexpr optional<string_view> fragment() const noexcept {
+    if (!parts_.has_fragment) {
+      return nullopt;
+    }
+    return parts_.fragment;
+  }
+
+  /// \returns The URL fragment with a leading `"#"`, as returned by
+  ///          `url::hash()`
+  constexpr string_view hash() const noexcept {
+    return with_delimiter(parts_.fragment);
+  }
+
+  /// \returns A `url_record` with the same components
+  url_record to_record() const;
+
+  /// \returns A `url` with the same components
+  url to_url() const;
+
+ private:
+
+  /// The input is only in serialized form if the port has no leading
+  /// zeros and isn't the default port
+  constexpr bool has_serialized_port() const noexcept {
+    auto port = parts_.port_string;
+    return
+        port.empty() ||
+        (parts_.has_port && ((port.size() == 1) || (port.front() != '0')));
+  }
+
+  /// \returns The component with the delimiter that precedes it, or
+  ///          an empty view if the component is empty
+  static constexpr string_view with_delimiter(string_view component) noexcept {
+    if (component.empty()) {
+      return string_view();
+    }
+    return string_view(component.data() - 1, component.size() + 1);
+  }
+
+  string_view href_;
+  details::fast_url_scan parts_;
+};
+
+/// User-defined literals for URLs
+namespace literals {
+/// Makes a `static_url` from a string literal
+///
+/// \param input The string literal
+/// \param length The length of the string literal
+/// \returns A `static_url`
+/// \throws url_parse_error if the input is not supported, which
+///         fails the build if the result is declared `constexpr`
+constexpr static_url operator "" _url(const char *input, std::size_t length) {
+  return static_url(std::string_view(input, length));
+}
+}  // namespace literals
+}  // namespace skyr
+
+#endif  // SKYR_STATIC_URL_INC
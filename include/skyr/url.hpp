@@ -8,6 +8,7 @@
 
 #include <string>
 #include <string_view>
+#include <utility>
 #include <skyr/config.hpp>
 #include <skyr/expected.hpp>
 #include <skyr/url_record.hpp>
@@ -43,6 +44,138 @@ class url_parse_error : public std::runtime_error {
 
 };
 
+/// Collects edits to several components of a `url`, which are
+/// applied together by `url::modify`
+///
+/// Each edit is validated as the corresponding `url` setter
+/// validates it, but is applied to a copy of the URL record, so
+/// nothing changes until every edit has succeeded. Once an edit
+/// fails, later edits are ignored and return the same error.
+class url_editor {
+ public:
+
+  /// Sets the [URL protocol](https://url.spec.whatwg.org/#dom-url-protocol)
+  ///
+  /// \param protocol The new URL protocol
+  /// \returns An error on failure to parse the new protocol
+  template <class Source>
+  expected<void, std::error_code> protocol(const Source &protocol) {
+    return edit(component::protocol, protocol);
+  }
+
+  /// Sets the [URL username](https://url.spec.whatwg.org/#dom-url-username)
+  ///
+  /// \param username The new username
+  /// \returns An error if the URL can't have a username
+  template <class Source>
+  expected<void, std::error_code> username(const Source &username) {
+    return edit(component::username, username);
+  }
+
+  /// Sets the [URL password](https://url.spec.whatwg.org/#dom-url-password)
+  ///
+  /// \param password The new password
+  /// \returns An error if the URL can't have a password
+  template <class Source>
+  expected<void, std::error_code> password(const Source &password) {
+    return edit(component::password, password);
+  }
+
+  /// Sets the [URL host](https://url.spec.whatwg.org/#dom-url-host)
+  ///
+  /// \param host The new URL host
+  /// \returns An error on failure to parse the new host
+  template <class Source>
+  expected<void, std::error_code> host(const Source &host) {
+    return edit(component::host, host);
+  }
+
+  /// Sets the [URL hostname](https://url.spec.whatwg.org/#dom-url-hostname)
+  ///
+  /// \param hostname The new URL host name
+  /// \returns An error on failure to parse the new host name
+  template <class Source>
+  expected<void, std::error_code> hostname(const Source &hostname) {
+    return edit(component::hostname, hostname);
+  }
+
+  /// Sets the [URL port](https://url.spec.whatwg.org/#dom-url-port)
+  ///
+  /// \param port The new port
+  /// \returns An error on failure to parse the new port
+  template <class Source>
+  expected<void, std::error_code> port(const Source &port) {
+    return edit(component::port, port);
+  }
+
+  /// Sets the [URL pathname](https://url.spec.whatwg.org/#dom-url-pathname)
+  ///
+  /// \param pathname The new pathname
+  /// \returns An error on failure to parse the new pathname
+  template <class Source>
+  expected<void, std::error_code> pathname(const Source &pathname) {
+    return edit(component::pathname, pathname);
+  }
+
+  /// Sets the [URL search string](https://url.spec.whatwg.org/#dom-url-search)
+  ///
+  /// \param search The new search string
+  /// \returns An error on failure to parse the new search string
+  template <class Source>
+  expected<void, std::error_code> search(const Source &search) {
+    return edit(component::search, search);
+  }
+
+  /// Sets the [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
+  ///
+  /// \param hash The new hash string
+  /// \returns An error on failure to parse the new hash string
+  template <class Source>
+  expected<void, std::error_code> hash(const Source &hash) {
+    return edit(component::hash, hash);
+  }
+
+  /// \returns The URL record with the edits so far
+  const url_record &record() const noexcept {
+    return record_;
+  }
+
+ private:
+
+  friend class url;
+
+  enum class component {
+    protocol,
+    username,
+    password,
+    host,
+    hostname,
+    port,
+    pathname,
+    search,
+    hash,
+  };
+
+  explicit url_editor(const url_record &record)
+    : record_(record, record.get_allocator()) {}
+
+  template <class Source>
+  expected<void, std::error_code> edit(component part, const Source &value) {
+    auto bytes = details::to_bytes(value);
+    if (!bytes) {
+      return edit_failed(make_error_code(url_parse_errc::invalid_unicode_character));
+    }
+    return edit(part, std::string_view(bytes.value()));
+  }
+
+  expected<void, std::error_code> edit(component part, std::string_view value);
+  expected<void, std::error_code> edit_failed(std::error_code error);
+
+  url_record record_;
+  optional<std::error_code> error_;
+  unsigned sections_ = 0;
+};
+
 /// Represents a URL. Parsing is performed according to the
 /// [WhatWG specification](https://url.spec.whatwg.org/)
 ///
@@ -59,7 +192,11 @@ class url_parse_error : public std::runtime_error {
 class url {
  public:
 
-  /// The internal ASCII string type, or `std::basic_string<value_type>`
+  /// The allocator used for the URL record, the serialized URL and
+  /// the search parameters
+  using allocator_type = url_record::allocator_type;
+  /// The ASCII string type returned by the accessors, or
+  /// `std::basic_string<value_type>`
   using string_type = std::string;
   /// The internal string_view, or `std::basic_string_view<value_type>`
   using string_view = std::string_view;
@@ -79,6 +216,13 @@ class url {
   /// \post `empty() == true`
   url();
 
+  /// Constructs an empty `url` object that allocates from `alloc`
+  ///
+  /// \param alloc The allocator used for the URL record, the
+  ///        serialized URL and the search parameters
+  /// \post `empty() == true`
+  explicit url(const allocator_type &alloc);
+
   /// Parses a URL from the input string. The input string can be
   /// any unicode encoded string (UTF-8, UTF-16 or UTF-32).
   ///
@@ -110,13 +254,85 @@ class url {
     initialize(std::move(bytes.value()), base.record());
   }
 
+  /// Parses a URL from the input string, allocating from `alloc`
+  ///
+  /// \tparam Source The input string type
+  /// \param input The input string
+  /// \param alloc The allocator used for the URL record, the
+  ///        serialized URL and the search parameters
+  /// \throws url_parse_error on parse errors
+  template<class Source>
+  url(const Source &input, const allocator_type &alloc)
+    : url(alloc) {
+    auto bytes = details::to_bytes(input);
+    if (!bytes) {
+      throw url_parse_error(make_error_code(url_parse_errc::invalid_unicode_character));
+    }
+    initialize(std::move(bytes.value()));
+  }
+
+  /// Parses a URL from the input string, allocating from `alloc`
+  ///
+  /// \tparam Source The input string type
+  /// \param input The input string
+  /// \param base A base URL
+  /// \param alloc The allocator used for the URL record, the
+  ///        serialized URL and the search parameters
+  /// \throws url_parse_error on parse errors
+  template<class Source>
+  url(const Source &input, const url &base, const allocator_type &alloc)
+    : url(alloc) {
+    auto bytes = details::to_bytes(input);
+    if (!bytes) {
+      throw url_parse_error(make_error_code(url_parse_errc::invalid_unicode_character));
+    }
+    initialize(std::move(bytes.value()), base.record());
+  }
+
   /// Constructs a URL from an existing record
   ///
+  /// The URL uses the same allocator as `input`
+  ///
   /// \param input A URL record
   explicit url(url_record &&input) noexcept;
 
+  /// Copy constructor
+  ///
+  /// As with the `std::pmr` containers, the copy uses the default
+  /// memory resource
+  ///
+  /// \param other Another `url` object
+  url(const url &other);
+
+  /// Move constructor
+  ///
+  /// \param other Another `url` object
+  url(url &&other) noexcept;
+
+  /// Copy assignment operator
+  ///
+  /// \param other Another `url` object
+  /// \returns `*this`
+  url &operator = (const url &other);
+
+  /// Move assignment operator
+  ///
+  /// \param other Another `url` object
+  /// \returns `*this`
+  url &operator = (url &&other);
+
+  /// Destructor
+  ~url() = default;
+
+  /// \returns The allocator used for the URL record, the serialized
+  ///          URL and the search parameters
+  allocator_type get_allocator() const noexcept {
+    return url_.get_allocator();
+  }
+
   /// Swaps this `url` object with another
   ///
+  /// \pre `get_allocator() == other.get_allocator()`
   /// \param other The other `url` object
   void swap(url &other) noexcept;
 
@@ -154,6 +370,14 @@ class url {
   /// \returns The [URL protocol](https://url.spec.whatwg.org/#dom-url-protocol)
   string_type protocol() const;
 
+  /// The URL protocol, as a view into the serialized URL
+  ///
+  /// Unlike `protocol()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `protocol()`
+  string_view protocol_view() const noexcept;
+
   /// Sets the [URL protocol](https://url.spec.whatwg.org/#dom-url-protocol)
   ///
   /// \param protocol The new URL protocol
@@ -171,6 +395,14 @@ class url {
   /// \returns The [URL username](https://url.spec.whatwg.org/#dom-url-username)
   string_type username() const;
 
+  /// The URL username, as a view into the URL record
+  ///
+  /// Unlike `username()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `username()`
+  string_view username_view() const noexcept;
+
   /// Sets the [URL username](https://url.spec.whatwg.org/#dom-url-username)
   ///
   /// \param username The new username
@@ -192,6 +424,14 @@ class url {
   /// \returns The URL password
   string_type password() const;
 
+  /// The URL password, as a view into the URL record
+  ///
+  /// Unlike `password()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `password()`
+  string_view password_view() const noexcept;
+
   /// Sets the [URL password](https://url.spec.whatwg.org/#dom-url-password)
   ///
   /// \param password The new password
@@ -209,6 +449,14 @@ class url {
   /// \returns The [URL host](https://url.spec.whatwg.org/#dom-url-host)
   string_type host() const;
 
+  /// The URL host, as a view into the serialized URL
+  ///
+  /// Unlike `host()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `host()`
+  string_view host_view() const noexcept;
+
   /// Sets the [URL host](https://url.spec.whatwg.org/#dom-url-host)
   ///
   /// \param host The new URL host
@@ -226,6 +474,14 @@ class url {
   /// \returns The [URL hostname](https://url.spec.whatwg.org/#dom-url-hostname)
   string_type hostname() const;
 
+  /// The URL host name, as a view into the serialized URL
+  ///
+  /// Unlike `hostname()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `hostname()`
+  string_view hostname_view() const noexcept;
+
   /// Sets the [URL hostname](https://url.spec.whatwg.org/#dom-url-hostname)
   ///
   /// \param hostname The new URL host name
@@ -243,6 +499,14 @@ class url {
   /// \returns The [URL port](https://url.spec.whatwg.org/#dom-url-port)
   string_type port() const;
 
+  /// The URL port, as a view into the serialized URL
+  ///
+  /// Unlike `port()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `port()`
+  string_view port_view() const noexcept;
+
   /// \returns The [URL port](https://url.spec.whatwg.org/#dom-url-port)
   template<typename intT>
   intT port(typename std::is_integral<intT>::type * = nullptr) const {
@@ -272,6 +536,14 @@ class url {
   /// \returns The URL pathname
   string_type pathname() const;
 
+  /// The URL pathname, as a view into the serialized URL
+  ///
+  /// Unlike `pathname()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `pathname()`
+  string_view pathname_view() const noexcept;
+
   /// Sets the [URL pathname](https://url.spec.whatwg.org/#dom-url-pathname)
   ///
   /// \param pathname The new pathname
@@ -291,6 +563,14 @@ class url {
   /// \returns The URL search string
   string_type search() const;
 
+  /// The URL search string, as a view into the serialized URL
+  ///
+  /// Unlike `search()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `search()`
+  string_view search_view() const noexcept;
+
   /// Sets the [URL search string](https://url.spec.whatwg.org/#dom-url-search)
   ///
   /// \param search The new search string
@@ -313,6 +593,14 @@ class url {
   /// \returns The URL hash string
   string_type hash() const;
 
+  /// The URL hash string, as a view into the serialized URL
+  ///
+  /// Unlike `hash()`, this doesn't allocate. The view is valid
+  /// until the URL is next modified.
+  ///
+  /// \returns The same characters as `hash()`
+  string_view hash_view() const noexcept;
+
   /// Sets the [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
   ///
   /// \param hash The new hash string
@@ -327,6 +615,30 @@ class url {
     return set_hash(std::move(bytes.value()));
   }
 
+  /// Edits several components of the URL at once
+  ///
+  /// `edit` is called with a `url_editor`. The edits are validated
+  /// one by one, but the URL is only serialized once, after they have
+  /// all succeeded. If any of them fails, the URL is unchanged.
+  ///
+  /// For example:
+  /// ```
+  /// auto result = url.modify([](skyr::url_editor &editor) {
+  ///   editor.host("example.org");
+  ///   editor.pathname("/moved");
+  ///   editor.search("");
+  /// });
+  /// ```
+  ///
+  /// \param edit A function that takes a `url_editor &`
+  /// \returns The error from the first edit that failed
+  template <class Edit>
+  expected<void, std::error_code> modify(Edit &&edit) {
+    auto editor = url_editor(url_);
+    std::forward<Edit>(edit)(editor);
+    return commit(std::move(editor));
+  }
+
   /// \returns A copy to the underlying `url_record` implementation.
   url_record record() const;
 
@@ -377,7 +689,7 @@ class url {
   /// \returns The default port if the scheme is special, `nullopt`
   ///          otherwise
   static optional<std::uint16_t> default_port(
-      const string_type &scheme) noexcept;
+      std::string_view scheme) noexcept;
 
   /// Clears the underlying URL string
   ///
@@ -396,10 +708,14 @@ class url {
 
  private:
 
+  friend class url_search_parameters;
+
   void initialize(
       string_type &&input,
       optional<url_record> base = nullopt);
   void update_record(url_record &&record);
+  expected<void, std::error_code> commit(url_editor &&editor);
+  void update_query(url_record::string_type &&query);
   expected<void, std::error_code> set_href(string_type &&href);
   expected<void, std::error_code> set_protocol(string_type &&protocol);
   expected<void, std::error_code> set_username(string_type &&username);
@@ -412,7 +728,7 @@ class url {
   expected<void, std::error_code> set_hash(string_type &&hash);
 
   url_record url_;
-  std::string href_;
+  url_record::string_type href_;
   string_view view_;
   url_search_parameters parameters_;
 };
@@ -427,7 +743,9 @@ void swap(url &lhs, url &rhs) noexcept;
 
 namespace details {
 expected<url, std::error_code> make_url(
-    url::string_type &&input, optional<url_record> base);
+    url::string_type &&input,
+    optional<url_record> base,
+    const url::allocator_type &alloc = url::allocator_type());
 }  // namespace details
 
 /// Parses a URL string and constructs a `url` object
@@ -463,6 +781,45 @@ inline expected<url, std::error_code> make_url(
   return details::make_url(std::move(bytes.value()), base.record());
 }
 
+/// Parses a URL string and constructs a `url` object that allocates
+/// from `alloc`
+///
+/// \tparam Source The input string type
+/// \param input The input string
+/// \param alloc The allocator used for the URL record, the
+///        serialized URL and the search parameters
+/// \returns A `url` object on success, an error on failure
+template<class Source>
+inline expected<url, std::error_code> make_url(
+    const Source &input, const url::allocator_type &alloc) {
+  auto bytes = details::to_bytes(input);
+  if (!bytes) {
+    return make_unexpected(
+        make_error_code(url_parse_errc::invalid_unicode_character));
+  }
+  return details::make_url(std::move(bytes.value()), nullopt, alloc);
+}
+
+/// Parses a URL string and constructs a `url` object that allocates
+/// from `alloc`
+///
+/// \tparam Source The input string type
+/// \param input The input string
+/// \param base The base URL
+/// \param alloc The allocator used for the URL record, the
+///        serialized URL and the search parameters
+/// \returns A `url` object on success, an error on failure
+template<class Source>
+inline expected<url, std::error_code> make_url(
+    const Source &input, const url &base, const url::allocator_type &alloc) {
+  auto bytes = details::to_bytes(input);
+  if (!bytes) {
+    return make_unexpected(
+        make_error_code(url_parse_errc::invalid_unicode_character));
+  }
+  return details::make_url(std::move(bytes.value()), base.record(), alloc);
+}
+
 /// Tests two URLs for equality according to the
 /// [WhatWG specification](https://url.spec.whatwg.org/#url-equivalence)
 ///
@@ -0,0 +1,86 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_AUTHORITY_INC
+#define SKYR_URL_AUTHORITY_INC
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <skyr/optional.hpp>
+#include <skyr/expected.hpp>
+#include <skyr/ipv4_address.hpp>
+#include <skyr/ipv6_address.hpp>
+
+namespace skyr {
+/// The types of host
+enum class url_host_type {
+  /// An ASCII domain
+  domain,
+  /// An IPv4 address
+  ipv4_address,
+  /// An IPv6 address
+  ipv6_address,
+  /// An opaque host, which is the host of a URL that isn't special
+  opaque,
+};
+
+/// A parsed host
+struct url_host {
+  /// The type of the host
+  url_host_type type;
+  /// The serialized host, as it would appear in a URL: an ASCII
+  /// domain, an IPv4 address in dotted decimal form, an IPv6 address
+  /// in square brackets or a percent encoded opaque host
+  std::string name;
+  /// The address, if `type` is `url_host_type::ipv4_address`
+  optional<ipv4_address> ipv4;
+  /// The address, if `type` is `url_host_type::ipv6_address`
+  optional<ipv6_address> ipv6;
+};
+
+/// A parsed host and optional port
+struct url_authority {
+  /// The host
+  url_host host;
+  /// The port, if any
+  optional<std::uint16_t> port;
+};
+
+/// Parses the value of an HTTP `Host` header, or an HTTP/2
+/// `:authority` pseudo-header, as the host and port of a special URL
+///
+/// The host is parsed in the same way as the host of a URL, so
+/// domains are converted to ASCII using IDNA processing and IP
+/// addresses are normalized. Credentials are not allowed. Plain
+/// ASCII domains are recognised in a single scan, without IDNA
+/// processing.
+///
+/// \code
+/// auto authority = skyr::parse_authority("EXAMPLE.com:8080");
+/// // authority.value().host.name == "example.com"
+/// // authority.value().port == 8080
+/// \endcode
+///
+/// \param input The authority, e.g. `"example.com:8080"`
+/// \returns The host and port on success and an error code on
+///          failure
+expected<url_authority, std::error_code> parse_authority(std::string_view input);
+
+/// Parses the host and port of a URL with the given scheme
+///
+/// The host is an opaque host if the scheme is not special, and the
+/// port is left out if it is the scheme's default port.
+///
+/// \param input The authority, e.g. `"example.com:8080"`
+/// \param scheme The scheme, e.g. `"https"`
+/// \returns The host and port on success and an error code on
+///          failure
+expected<url_authority, std::error_code> parse_authority(
+    std::string_view input, std::string_view scheme);
+}  // namespace skyr
+
+#endif  // SKYR_URL_AUTHORITY_INC
@@ -0,0 +1,273 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_BATCH_INC
+#define SKYR_URL_BATCH_INC
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <skyr/optional.hpp>
+#include <skyr/expected.hpp>
+#include <skyr/url_record.hpp>
+#include <skyr/details/url_components.hpp>
+
+namespace skyr {
+/// The result of parsing many URLs at once
+///
+/// The components of every URL in the batch are stored in a single
+/// monotonic arena owned by the batch, which is released in one go
+/// when the batch is destroyed. Schemes and hosts that appear more
+/// than once in a batch are stored once, and the set used to find
+/// them is in the arena too.
+///
+/// Inputs that the fast path can't parse are parsed into a scratch
+/// arena, which is reused for each input and takes any extra memory
+/// it needs from the batch's arena. The parser's own temporary
+/// strings (a sanitized copy of the input, the buffer for the
+/// scheme and host, and the strings used for IDNA processing and IP
+/// addresses) still come from the global heap.
+///
+/// The components returned by each entry are valid for as long as
+/// the batch is alive. A batch can be moved, but not copied.
+class url_batch {
+
+ public:
+
+  /// ASCII string type
+  using string_type = std::string;
+  /// A view into the batch's arena
+  using string_view = std::string_view;
+
+  /// A parsed URL whose components are stored in the batch
+  class entry {
+   public:
+
+    /// A forward iterator over the path segments
+    using path_iterator = details::url_path_iterator;
+
+    /// \returns The URL scheme
+    string_view scheme() const noexcept {
+      return scheme_;
+    }
+
+    /// \returns The URL username
+    string_view username() const noexcept {
+      return username_;
+    }
+
+    /// \returns The URL password
+    string_view password() const noexcept {
+      return password_;
+    }
+
+    /// \returns The serialized host, or `nullopt` if there is none
+    optional<string_view> host() const noexcept {
+      if (!has(details::url_components::has_host_flag)) {
+        return nullopt;
+      }
+      return host_;
+    }
+
+    /// \returns The URL port, or `nullopt` if there is none
+    optional<std::uint16_t> port() const noexcept {
+      if (!has(details::url_components::has_port_flag)) {
+        return nullopt;
+      }
+      return port_;
+    }
+
+    /// \returns The serialized path, as returned by `url::pathname()`
+    string_view pathname() const noexcept {
+      return pathname_;
+    }
+
+    /// \returns The URL query, or `nullopt` if there is none
+    optional<string_view> query() const noexcept {
+      if (!has(details::url_components::has_query_flag)) {
+        return nullopt;
+      }
+      return query_;
+    }
+
+    /// \returns The URL fragment, or `nullopt` if there is none
+    optional<string_view> fragment() const noexcept {
+      if (!has(details::url_components::has_fragment_flag)) {
+        return nullopt;
+      }
+      return fragment_;
+    }
+
+    /// \returns An iterator to the first path segment
+    path_iterator path_begin() const noexcept {
+      return path_iterator(pathname_, cannot_be_a_base_url());
+    }
+
+    /// \returns An iterator past the last path segment
+    path_iterator path_end() const noexcept {
+      return path_iterator();
+    }
+
+    /// \returns `true` if this URL cannot be used as a base URL
+    bool cannot_be_a_base_url() const noexcept {
+      return has(details::url_components::cannot_be_a_base_url_flag);
+    }
+
+    /// \returns `true` if a non-fatal validation error occurred
+    ///          during parsing
+    bool validation_error() const noexcept {
+      return has(details::url_components::validation_error_flag);
+    }
+
+    /// \returns The serialized URL
+    string_type href() const;
+
+    /// \returns A `url_record` with the same components
+    url_record to_record() const;
+
+   private:
+
+    friend class url_batch;
+
+    bool has(std::uint8_t flag) const noexcept {
+      return (flags_ & flag) != 0;
+    }
+
+    string_view scheme_;
+    string_view username_;
+    string_view password_;
+    string_view host_;
+    string_view pathname_;
+    string_view query_;
+    string_view fragment_;
+    std::uint16_t port_ = 0;
+    std::uint8_t flags_ = 0;
+  };
+
+  /// The result of parsing one input
+  using value_type = expected<entry, std::error_code>;
+  /// A reference to the result of parsing one input
+  using const_reference = const value_type &;
+  /// An iterator over the results, in input order
+  using const_iterator = std::vector<value_type>::const_iterator;
+  /// An unsigned integral type
+  using size_type = std::size_t;
+
+  /// Constructs an empty batch
+  ///
+  /// \param base An optional base URL used for every input
+  /// \param initial_size The size of the first arena block
+  explicit url_batch(
+      optional<url_record> base = nullopt,
+      size_type initial_size = 4096);
+
+  url_batch(const url_batch &) = delete;
+  url_batch(url_batch &&) noexcept;
+  url_batch &operator = (const url_batch &) = delete;
+  url_batch &operator = (url_batch &&) noexcept;
+  ~url_batch();
+
+  /// Parses a URL and appends the result to the batch
+  ///
+  /// \param input The input string, which is copied into the arena
+  /// \returns The result of parsing the input
+  const_reference push_back(string_view input);
+
+  /// Reserves space for the results of `count` inputs
+  /// \param count The number of inputs
+  void reserve(size_type count) {
+    results_.reserve(count);
+  }
+
+  /// \returns An iterator to the first result
+  const_iterator begin() const noexcept {
+    return results_.begin();
+  }
+
+  /// \returns An iterator past the last result
+  const_iterator end() const noexcept {
+    return results_.end();
+  }
+
+  /// \param index The position of the input
+  /// \returns The result of parsing the input at `index`
+  const_reference operator [] (size_type index) const noexcept {
+    return results_[index];
+  }
+
+  /// \returns The number of results
+  size_type size() const noexcept {
+    return results_.size();
+  }
+
+  /// \returns `true` if the batch is empty
+  bool empty() const noexcept {
+    return results_.empty();
+  }
+
+ private:
+
+  string_view copy(string_view value);
+  string_view intern(string_view value);
+  void push_back_record(const url_record &record, entry &result);
+
+  struct arena;
+
+  optional<url_record> base_;
+  std::unique_ptr<arena> arena_;
+  std::vector<value_type> results_;
+};
+
+/// Parses a sequence of URLs into a single `url_batch`
+///
+/// \param first An iterator to the first input
+/// \param last An iterator past the last input
+/// \param base An optional base URL used for every input
+/// \returns A `url_batch` with one result per input, in order
+template <class InputIterator>
+url_batch parse_batch(
+    InputIterator first, InputIterator last,
+    const optional<url_record> &base = nullopt) {
+  using category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+  auto initial_size = std::size_t{4096};
+  auto count = std::size_t{0};
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    auto size = std::size_t{0};
+    for (auto it = first; it != last; ++it, ++count) {
+      size += std::string_view(*it).size();
+    }
+    initial_size = (size > initial_size)? size : initial_size;
+  }
+
+  auto batch = url_batch(base, initial_size);
+  batch.reserve(count);
+  for (auto it = first; it != last; ++it) {
+    batch.push_back(std::string_view(*it));
+  }
+  return batch;
+}
+
+/// Parses a range of URLs into a single `url_batch`
+///
+/// \param inputs A range of input strings
+/// \param base An optional base URL used for every input
+/// \returns A `url_batch` with one result per input, in order
+template <class InputRange>
+url_batch parse_batch(
+    const InputRange &inputs,
+    const optional<url_record> &base = nullopt) {
+  return parse_batch(std::begin(inputs), std::end(inputs), base);
+}
+}  // namespace skyr
+
+#endif  // SKYR_URL_BATCH_INC
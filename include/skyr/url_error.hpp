@@ -37,17 +37,69 @@ enum class url_parse_errc {
   cannot_have_a_username_password_or_port,
   /// Invalid port value.
   invalid_port,
+  /// Input is longer than the maximum length
+  input_too_long,
+  /// Input is not a valid HTTP request target
+  invalid_request_target,
+  /// Input is not a URL that `static_url` can represent
+  not_a_static_url,
 };
 
 /// Creates a `std::error_code` given a `skyr::url_parse_errc` value
 /// \param error A URL parse error
 /// \returns A `std::error_code` object
 std::error_code make_error_code(url_parse_errc error);
+
+/// Enumerates URL validation errors
+///
+/// A validation error doesn't stop the parser, but the input isn't
+/// a valid URL string. The names follow those used in the WhatWG URL
+/// specification.
+enum class url_validation_errc {
+  /// Input has leading or trailing C0 control or space characters
+  leading_or_trailing_c0_control_or_space=1,
+  /// Input contains a tab or newline
+  tab_or_newline,
+  /// Code point is not a URL code point, or a `'%'` is not followed
+  /// by two hex digits
+  invalid_url_unit,
+  /// Special scheme is not followed by `"//"`
+  special_scheme_missing_following_solidus,
+  /// Input has no scheme and there is no base URL it can be
+  /// resolved against
+  missing_scheme_non_relative_url,
+  /// `'\\'` is used instead of `'/'` in a special URL
+  invalid_reverse_solidus,
+  /// URL includes credentials
+  invalid_credentials,
+  /// Host is empty
+  host_missing,
+  /// Port is too large
+  port_out_of_range,
+  /// Port contains a character that is not a digit
+  port_invalid,
+  /// Relative file URL starts with a Windows drive letter
+  file_invalid_windows_drive_letter,
+  /// File URL's host is a Windows drive letter, or is removed
+  /// because the path starts with one
+  file_invalid_windows_drive_letter_host,
+  /// File URL path starts with empty segments, which are removed
+  file_empty_path_segment,
+};
+
+/// Creates a `std::error_code` given a `skyr::url_validation_errc`
+/// value
+/// \param error A URL validation error
+/// \returns A `std::error_code` object
+std::error_code make_error_code(url_validation_errc error);
 }  // namespace skyr
 
 namespace std {
 template <>
 struct is_error_code_enum<skyr::url_parse_errc> : true_type {};
+
+template <>
+struct is_error_code_enum<skyr::url_validation_errc> : true_type {};
 }  // namespace std
 
 #endif // SKYR_URL_ERROR_INC
@@ -0,0 +1,173 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_PARALLEL_INC
+#define SKYR_URL_PARALLEL_INC
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <vector>
+#include <skyr/optional.hpp>
+#include <skyr/url_record.hpp>
+#include <skyr/url_batch.hpp>
+
+namespace skyr {
+/// Options for `parse_parallel`
+struct parallel_parse_options {
+  /// The number of threads, including the calling thread, or `0` to
+  /// use `std::thread::hardware_concurrency()`
+  std::size_t thread_count = 0;
+  /// The number of consecutive inputs that a thread parses at a time
+  std::size_t chunk_size = 1024;
+};
+
+/// The result of parsing many URLs on several threads
+///
+/// Each thread parses into its own `url_batch`, so every thread has
+/// its own arena and its own host cache. Results are accessed in
+/// input order.
+class parallel_url_batch {
+
+ public:
+
+  /// The result of parsing one input
+  using value_type = url_batch::value_type;
+  /// A reference to the result of parsing one input
+  using const_reference = url_batch::const_reference;
+  /// An unsigned integral type
+  using size_type = std::size_t;
+
+  /// An iterator over the results, in input order
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = parallel_url_batch::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    const_iterator() noexcept = default;
+
+    const_iterator(const parallel_url_batch *batch, size_type index) noexcept
+      : batch_(batch), index_(index) {}
+
+    reference operator * () const noexcept {
+      return (*batch_)[index_];
+    }
+
+    pointer operator -> () const noexcept {
+      return &(*batch_)[index_];
+    }
+
+    const_iterator &operator ++ () noexcept {
+      ++index_;
+      return *this;
+    }
+
+    const_iterator operator ++ (int) noexcept {
+      auto result = *this;
+      ++index_;
+      return result;
+    }
+
+    bool operator == (const const_iterator &other) const noexcept {
+      return (batch_ == other.batch_) && (index_ == other.index_);
+    }
+
+    bool operator != (const const_iterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+   private:
+    const parallel_url_batch *batch_ = nullptr;
+    size_type index_ = 0;
+  };
+
+  /// Constructs an empty batch
+  parallel_url_batch() = default;
+
+  /// \param index The position of the input
+  /// \returns The result of parsing the input at `index`
+  const_reference operator [] (size_type index) const noexcept {
+    const auto &chunk = chunks_[index / chunk_size_];
+    return batches_[chunk.batch][chunk.first + (index % chunk_size_)];
+  }
+
+  /// \returns An iterator to the first result
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  /// \returns An iterator past the last result
+  const_iterator end() const noexcept {
+    return const_iterator(this, size_);
+  }
+
+  /// \returns The number of results
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  /// \returns `true` if the batch is empty
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  /// \returns The number of threads that parsed this batch
+  size_type thread_count() const noexcept {
+    return batches_.size();
+  }
+
+ private:
+
+  friend parallel_url_batch parse_parallel(
+      const std::vector<std::string_view> &inputs,
+      const optional<url_record> &base,
+      const parallel_parse_options &options);
+
+  struct chunk_location {
+    size_type batch;
+    size_type first;
+  };
+
+  std::vector<url_batch> batches_;
+  std::vector<chunk_location> chunks_;
+  size_type chunk_size_ = 1;
+  size_type size_ = 0;
+};
+
+/// Parses a large number of URLs on a work-stealing thread pool
+///
+/// The inputs are split into chunks of `options.chunk_size`. Each
+/// thread starts with an equal share of the chunks, and when it runs
+/// out it steals half of the remaining chunks from another thread.
+///
+/// \param inputs The input strings
+/// \param base An optional base URL used for every input
+/// \param options The number of threads and the chunk size
+/// \returns The results, in input order
+parallel_url_batch parse_parallel(
+    const std::vector<std::string_view> &inputs,
+    const optional<url_record> &base = nullopt,
+    const parallel_parse_options &options = parallel_parse_options{});
+
+/// Parses a newline-delimited buffer of URLs on a work-stealing
+/// thread pool
+///
+/// Each line is one input. A trailing `"\r"` is removed from each
+/// line, and a final newline does not start an extra input.
+///
+/// \param buffer A buffer of newline-delimited URLs
+/// \param base An optional base URL used for every input
+/// \param options The number of threads and the chunk size
+/// \returns The results, in input order
+parallel_url_batch parse_parallel_lines(
+    std::string_view buffer,
+    const optional<url_record> &base = nullopt,
+    const parallel_parse_options &options = parallel_parse_options{});
+}  // namespace skyr
+
+#endif  // SKYR_URL_PARALLEL_INC
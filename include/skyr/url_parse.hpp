@@ -6,21 +6,181 @@
 #ifndef SKYR_URL_PARSE_INC
 #define SKYR_URL_PARSE_INC
 
+#include <cstddef>
+#include <limits>
+#include <string_view>
 #include <system_error>
 #include <skyr/optional.hpp>
 #include <skyr/expected.hpp>
 #include <skyr/url_record.hpp>
+#include <skyr/url_validation_policy.hpp>
 #include <skyr/details/to_bytes.hpp>
 
 namespace skyr {
+/// The components of a URL, in the order in which they are parsed
+enum class url_component {
+  /// The scheme
+  scheme,
+  /// The username
+  username,
+  /// The password
+  password,
+  /// The host
+  host,
+  /// The port
+  port,
+  /// The path
+  path,
+  /// The query
+  query,
+  /// The fragment
+  fragment,
+};
+
+/// Options for `parse`
+struct url_parse_options {
+  /// Inputs longer than this, in bytes, are rejected before any
+  /// parsing is done
+  std::size_t max_input_length = std::numeric_limits<std::size_t>::max();
+};
+
+/// Parses a URL and returns a `url_record`
+///
+/// Every component of the returned record allocates from `alloc`,
+/// so passing a `std::pmr::polymorphic_allocator` constructed from a
+/// request-scoped `std::pmr::monotonic_buffer_resource` lets all of
+/// the record's memory be released at once.
+///
+/// \param input The input string
+/// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
+/// \returns A `url_record` on success and an error code on failure
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+
 /// Parses a URL and returns a `url_record`
 ///
+/// The parser's running time is linear in the length of the input,
+/// so limiting the length of untrusted input also limits the time
+/// spent parsing it.
+///
+/// \param input The input string
+/// \param options The parse options
+/// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
+/// \returns A `url_record` on success and an error code on
+///          failure, which is `url_parse_errc::input_too_long` if the
+///          input is longer than `options.max_input_length`
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    const url_parse_options &options,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+
+/// Parses a URL and returns a `url_record`, discarding validation
+/// errors
+///
+/// `url_record::validation_error` is never set, and the parser
+/// doesn't do the work of detecting validation errors.
+///
+/// \param input The input string
+/// \param policy The validation policy
+/// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
+/// \returns A `url_record` on success and an error code on failure
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    ignore_validation_errors policy,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+
+/// Parses a URL and returns a `url_record`, failing on the first
+/// validation error
+///
+/// \param input The input string
+/// \param policy The validation policy
+/// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
+/// \returns A `url_record` on success and an error code on failure,
+///          which is a `url_validation_errc` if the input has a
+///          validation error
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    fail_on_validation_error policy,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+
+/// Parses a URL and returns a `url_record`, collecting every
+/// validation error
+///
+/// \code
+/// auto errors = skyr::collect_validation_errors{};
+/// auto url = skyr::parse(" http:\\\\example.com\\a b", errors);
+/// for (auto &&error : errors.errors()) {
+///   std::cout << error.offset << ": "
+///             << make_error_code(error.code).message() << std::endl;
+/// }
+/// \endcode
+///
 /// \param input The input string
+/// \param policy The validation policy, which holds the validation
+///        errors when this function returns
 /// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
 /// \returns A `url_record` on success and an error code on failure
 expected<url_record, std::error_code> parse(
-    url_record::string_type input,
+    std::string_view input,
+    collect_validation_errors &policy,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+
+/// Tests if the input is a valid URL, without building a
+/// `url_record`
+///
+/// Host parsing and validation are the same as for `parse`, but the
+/// path, query and fragment are not percent encoded or stored, so
+/// rejecting or accepting an input is much cheaper than parsing it.
+///
+/// \param input The input string
+/// \param base An optional base URL
+/// \returns `true` if `parse(input, base)` would succeed, `false`
+///          otherwise
+bool is_valid_url(
+    std::string_view input,
     const optional<url_record> &base = nullopt);
+
+/// Parses a URL up to, and including, the given component and
+/// returns a partially filled `url_record`
+///
+/// The parser stops as soon as `last` is known, so the components
+/// after it are left empty and errors in them are not reported. The
+/// username, password, host and port are all known once the whole
+/// authority has been parsed, so e.g. `url_component::host` also
+/// fills in the port. A file URL's host depends on its first path
+/// segment, so for file URLs the path is parsed too.
+/// `parse_until(input, url_component::fragment)` is the same as
+/// `parse(input)`.
+///
+/// \code
+/// auto url = skyr::parse_until(
+///     "https://example.com:8080/a/very/long/path?q", skyr::url_component::host);
+/// // url.value().host == "example.com", url.value().port == 8080
+/// // url.value().path.empty()
+/// \endcode
+///
+/// \param input The input string
+/// \param last The last component to parse
+/// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
+/// \returns A partially filled `url_record` on success and an error
+///          code on failure
+expected<url_record, std::error_code> parse_until(
+    std::string_view input,
+    url_component last,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
 }  // namespace skyr
 
 #endif  // SKYR_URL_PARSE_INC
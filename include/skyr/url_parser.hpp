@@ -0,0 +1,74 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_PARSER_INC
+#define SKYR_URL_PARSER_INC
+
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <skyr/optional.hpp>
+#include <skyr/expected.hpp>
+#include <skyr/url_record.hpp>
+
+namespace skyr {
+/// Parses URLs one after another, keeping its memory between them
+///
+/// The parsed record's components allocate from an arena owned by
+/// the parser, which is reset, and grown if it was too small, by each
+/// call to `parse`. The parser's scratch buffers keep their capacity
+/// too, so once the parser has seen a few inputs it parses similar
+/// URLs without any heap allocations. Hosts that need IDNA processing
+/// and IP addresses are still normalized using temporary strings.
+///
+/// The record returned by `url` is only valid until the next call
+/// to `parse`; copy it to keep it. A `url_parser` must not be used by
+/// more than one thread at a time, so use one per thread.
+///
+/// \code
+/// auto parser = skyr::url_parser{};
+/// for (auto &&line : lines) {
+///   if (parser.parse(line)) {
+///     std::cout << parser.url().host.value() << std::endl;
+///   }
+/// }
+/// \endcode
+class url_parser {
+ public:
+
+  /// Constructor
+  ///
+  /// \param base An optional base URL
+  explicit url_parser(optional<url_record> base = nullopt);
+
+  /// Move constructor
+  url_parser(url_parser &&other) noexcept;
+
+  /// Move assignment operator
+  url_parser &operator = (url_parser &&other) noexcept;
+
+  /// Destructor
+  ~url_parser();
+
+  /// Parses a URL
+  ///
+  /// The result is the same as `skyr::parse(input, base)`.
+  ///
+  /// \param input The input string
+  /// \returns An error code on failure
+  expected<void, std::error_code> parse(std::string_view input);
+
+  /// \returns The record parsed by the last call to `parse`, which
+  ///          is empty if it failed and is valid until the next call
+  const url_record &url() const noexcept;
+
+ private:
+
+  struct impl;
+  std::unique_ptr<impl> impl_;
+};
+}  // namespace skyr
+
+#endif  // SKYR_URL_PARSER_INC
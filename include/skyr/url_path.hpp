@@ -0,0 +1,345 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_PATH_INC
+#define SKYR_URL_PATH_INC
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace skyr {
+/// The path of a URL: a list of zero or more ASCII segments
+///
+/// The segments are stored one after another in a single string,
+/// separated by `'/'`, with a table of where each one ends, so a path
+/// makes at most two allocations however many segments it has, and
+/// removing the last segment is constant time. Segments are returned
+/// as views into the path, which are valid until it is next modified.
+///
+/// Because segments are separated by `'/'`, the serialized form of
+/// a hierarchical path is `"/"` followed by `joined()`.
+class url_path {
+
+ public:
+
+  /// The allocator used by the path
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+  /// A path segment
+  using value_type = std::string_view;
+  /// A path segment, returned by value
+  using reference = std::string_view;
+  /// A path segment, returned by value
+  using const_reference = std::string_view;
+  /// An unsigned integral type
+  using size_type = std::size_t;
+  /// A signed integral type
+  using difference_type = std::ptrdiff_t;
+
+  /// A random access iterator over the segments
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    const_iterator() noexcept = default;
+
+    const_iterator(const url_path *path, size_type index) noexcept
+      : path_(path), index_(index) {}
+
+    reference operator * () const noexcept {
+      return (*path_)[index_];
+    }
+
+    reference operator [] (difference_type n) const noexcept {
+      return (*path_)[index_ + n];
+    }
+
+    const_iterator &operator ++ () noexcept {
+      ++index_;
+      return *this;
+    }
+
+    const_iterator operator ++ (int) noexcept {
+      auto result = *this;
+      ++index_;
+      return result;
+    }
+
+    const_iterator &operator -- () noexcept {
+      --index_;
+      return *this;
+    }
+
+    const_iterator operator -- (int) noexcept {
+      auto result = *this;
+      --index_;
+      return result;
+    }
+
+    const_iterator &operator += (difference_type n) noexcept {
+      index_ += n;
+      return *this;
+    }
+
+    const_iterator &operator -= (difference_type n) noexcept {
+      index_ -= n;
+      return *this;
+    }
+
+    const_iterator operator + (difference_type n) const noexcept {
+      return const_iterator(path_, index_ + n);
+    }
+
+    const_iterator operator - (difference_type n) const noexcept {
+      return const_iterator(path_, index_ - n);
+    }
+
+    difference_type operator - (const const_iterator &other) const noexcept {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    bool operator == (const const_iterator &other) const noexcept {
+      return index_ == other.index_;
+    }
+
+    bool operator != (const const_iterator &other) const noexcept {
+      return index_ != other.index_;
+    }
+
+    bool operator < (const const_iterator &other) const noexcept {
+      return index_ < other.index_;
+    }
+
+    bool operator > (const const_iterator &other) const noexcept {
+      return index_ > other.index_;
+    }
+
+    bool operator <= (const const_iterator &other) const noexcept {
+      return index_ <= other.index_;
+    }
+
+    bool operator >= (const const_iterator &other) const noexcept {
+      return index_ >= other.index_;
+    }
+
+    /// \returns The index of the segment
+    size_type index() const noexcept {
+      return index_;
+    }
+
+   private:
+    const url_path *path_ = nullptr;
+    size_type index_ = 0;
+  };
+
+  /// A random access iterator over the segments
+  using iterator = const_iterator;
+
+  /// Constructor
+  url_path()
+    : url_path(allocator_type()) {}
+
+  /// Constructs an empty path that allocates from `alloc`
+  ///
+  /// \param alloc An allocator
+  explicit url_path(const allocator_type &alloc)
+    : joined_(alloc), ends_(alloc) {}
+
+  /// Constructs a path from a list of segments
+  ///
+  /// \param segments The segments
+  /// \param alloc An allocator
+  url_path(
+      std::initializer_list<std::string_view> segments,
+      const allocator_type &alloc = allocator_type())
+    : url_path(alloc) {
+    for (auto segment : segments) {
+      push_back(segment);
+    }
+  }
+
+  /// Copy constructor
+  ///
+  /// As with the `std::pmr` containers, the copy uses the default
+  /// memory resource
+  ///
+  /// \param other Another `url_path` object
+  url_path(const url_path &other) = default;
+
+  /// Copies a path so that it allocates from `alloc`
+  ///
+  /// \param other Another `url_path` object
+  /// \param alloc An allocator
+  url_path(const url_path &other, const allocator_type &alloc)
+    : joined_(other.joined_, alloc), ends_(other.ends_, alloc) {}
+
+  /// Move constructor
+  url_path(url_path &&other) noexcept = default;
+
+  /// Copy assignment operator
+  ///
+  /// The allocator of this path is unchanged
+  url_path &operator = (const url_path &other) = default;
+
+  /// Move assignment operator
+  ///
+  /// The allocator of this path is unchanged
+  url_path &operator = (url_path &&other) = default;
+
+  /// Destructor
+  ~url_path() = default;
+
+  /// \returns The allocator used by the path
+  allocator_type get_allocator() const noexcept {
+    return joined_.get_allocator();
+  }
+
+  /// \returns An iterator to the first segment
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  /// \returns An iterator past the last segment
+  const_iterator end() const noexcept {
+    return const_iterator(this, size());
+  }
+
+  /// \returns `true` if there are no segments
+  bool empty() const noexcept {
+    return ends_.empty();
+  }
+
+  /// \returns The number of segments
+  size_type size() const noexcept {
+    return ends_.size();
+  }
+
+  /// \param index The index of a segment
+  /// \returns The segment
+  std::string_view operator [] (size_type index) const noexcept {
+    assert(index < size());
+    auto first = (index == 0)? size_type(0) : ends_[index - 1] + 1;
+    return std::string_view(joined_).substr(first, ends_[index] - first);
+  }
+
+  /// \returns The first segment
+  std::string_view front() const noexcept {
+    return (*this)[0];
+  }
+
+  /// \returns The last segment
+  std::string_view back() const noexcept {
+    return (*this)[size() - 1];
+  }
+
+  /// \returns The segments, separated by `'/'`
+  std::string_view joined() const noexcept {
+    return joined_;
+  }
+
+  /// Reserves storage for the segments
+  ///
+  /// \param bytes The number of bytes in the segments and the
+  ///        separators between them
+  /// \param segments The number of segments
+  void reserve(size_type bytes, size_type segments) {
+    joined_.reserve(bytes);
+    ends_.reserve(segments);
+  }
+
+  /// Adds a segment to the end of the path
+  ///
+  /// \param segment The new segment
+  void push_back(std::string_view segment) {
+    if (!empty()) {
+      joined_.push_back('/');
+    }
+    joined_.append(segment.data(), segment.size());
+    ends_.push_back(static_cast<std::uint32_t>(joined_.size()));
+  }
+
+  /// Adds a segment to the end of the path
+  ///
+  /// \param segment The new segment, which is empty by default
+  void emplace_back(std::string_view segment = std::string_view()) {
+    push_back(segment);
+  }
+
+  /// Appends bytes to the last segment
+  ///
+  /// \pre `!empty()`
+  /// \param bytes The bytes to append
+  void append_to_back(std::string_view bytes) {
+    assert(!empty());
+    joined_.append(bytes.data(), bytes.size());
+    ends_.back() = static_cast<std::uint32_t>(joined_.size());
+  }
+
+  /// Removes the last segment
+  ///
+  /// \pre `!empty()`
+  void pop_back() noexcept {
+    assert(!empty());
+    ends_.pop_back();
+    joined_.resize(empty()? 0 : ends_.back());
+  }
+
+  /// Removes a range of segments
+  ///
+  /// \param first The first segment to remove
+  /// \param last The segment after the last one to remove
+  /// \returns An iterator to the segment after the last one removed
+  const_iterator erase(const_iterator first, const_iterator last);
+
+  /// Removes every segment, keeping the capacity
+  void clear() noexcept {
+    joined_.clear();
+    ends_.clear();
+  }
+
+  /// Swaps two paths
+  ///
+  /// \pre `get_allocator() == other.get_allocator()`
+  /// \param other Another `url_path` object
+  void swap(url_path &other) noexcept {
+    joined_.swap(other.joined_);
+    ends_.swap(other.ends_);
+  }
+
+ private:
+
+  std::pmr::string joined_;
+  std::pmr::vector<std::uint32_t> ends_;
+
+};
+
+/// \returns `true` if the paths have the same segments
+bool operator == (const url_path &lhs, const url_path &rhs) noexcept;
+
+/// \returns `true` if the paths don't have the same segments
+inline bool operator != (const url_path &lhs, const url_path &rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+/// Swaps two `url_path` objects
+///
+/// \param lhs A `url_path` object
+/// \param rhs A `url_path` object
+inline void swap(url_path &lhs, url_path &rhs) noexcept {
+  lhs.swap(rhs);
+}
+}  // namespace skyr
+
+#endif  // SKYR_URL_PATH_INC
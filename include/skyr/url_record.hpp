@@ -8,8 +8,11 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <memory_resource>
 #include <skyr/optional.hpp>
+#include <skyr/url_path.hpp>
 
 namespace skyr {
 /// Represents the parts of a URL identifier
@@ -17,9 +20,12 @@ class url_record {
 
  public:
 
+  /// The allocator used for every component
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
   /// ASCII string type
   /// \sa url::string_type
-  using string_type = std::string;
+  using string_type = std::pmr::string;
 
   /// An ASCII string that identifies the type of URL
   string_type scheme;
@@ -34,7 +40,7 @@ class url_record {
   optional<std::uint16_t> port;
   /// A list of zero or more ASCII strings, used to identify a
   /// location in a hierarchical form
-  std::vector<string_type> path;
+  url_path path;
   /// An optional ASCII string
   optional<string_type> query;
   /// An optional ASCII string
@@ -50,7 +56,60 @@ class url_record {
 
   /// Constructor
   url_record()
-    : cannot_be_a_base_url{false} {}
+    : url_record(allocator_type()) {}
+
+  /// Constructs an empty record whose components allocate from
+  /// `alloc`
+  ///
+  /// \param alloc An allocator
+  explicit url_record(const allocator_type &alloc)
+    : scheme(alloc)
+    , username(alloc)
+    , password(alloc)
+    , path(alloc)
+    , cannot_be_a_base_url{false}
+    , validation_error{false} {}
+
+  /// Copy constructor
+  ///
+  /// As with the `std::pmr` containers, the copy uses the default
+  /// memory resource
+  ///
+  /// \param other Another `url_record` object
+  url_record(const url_record &other) = default;
+
+  /// Copies a record so that its components allocate from `alloc`
+  ///
+  /// \param other Another `url_record` object
+  /// \param alloc An allocator
+  url_record(const url_record &other, const allocator_type &alloc);
+
+  /// Move constructor
+  url_record(url_record &&other) noexcept = default;
+
+  /// Copy assignment operator
+  ///
+  /// The allocator of this record is unchanged
+  url_record &operator = (const url_record &other);
+
+  /// Move assignment operator
+  ///
+  /// The allocator of this record is unchanged
+  url_record &operator = (url_record &&other);
+
+  /// Destructor
+  ~url_record() = default;
+
+  /// \returns The allocator used for every component
+  allocator_type get_allocator() const noexcept {
+    return scheme.get_allocator();
+  }
+
+  /// \param value A string
+  /// \returns A copy of `value` that uses this record's allocator
+  string_type make_string(std::string_view value = std::string_view()) const {
+    return string_type(value, get_allocator());
+  }
 
   /// Tests if the URL is a special scheme
   /// \returns `true` if the URL scheme is a special scheme, `false`
@@ -68,6 +127,8 @@ class url_record {
   bool cannot_have_a_username_password_or_port() const noexcept;
 
   /// Swaps two `url_record` objects
+  ///
+  /// \pre `get_allocator() == other.get_allocator()`
   /// \param other Another `url_record` object
   void swap(url_record &other) noexcept;
 
@@ -80,6 +141,30 @@ class url_record {
 /// \param lhs A `url_record` object
 /// \param rhs A `url_record` object
 void swap(url_record &lhs, url_record &rhs) noexcept;
+
+/// \exclude
+namespace details {
+/// Assigns an optional component, so that a newly engaged value
+/// allocates from `alloc`
+///
+/// \param lhs The component to assign to
+/// \param rhs The new value
+/// \param alloc The allocator of the record that owns `lhs`
+inline void assign(
+    optional<url_record::string_type> &lhs,
+    const optional<url_record::string_type> &rhs,
+    const url_record::allocator_type &alloc) {
+  if (!rhs) {
+    lhs = nullopt;
+  }
+  else if (lhs) {
+    lhs.value() = rhs.value();
+  }
+  else {
+    lhs = url_record::string_type(rhs.value(), alloc);
+  }
+}
+}  // namespace details
 }  // namespace skyr
 
 #endif // SKYR_URL_RECORD_INC
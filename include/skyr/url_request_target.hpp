@@ -0,0 +1,81 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_REQUEST_TARGET_INC
+#define SKYR_URL_REQUEST_TARGET_INC
+
+#include <string_view>
+#include <system_error>
+#include <skyr/expected.hpp>
+#include <skyr/url_record.hpp>
+
+namespace skyr {
+/// The forms of an HTTP request target, as described in RFC 7230,
+/// section 5.3
+enum class request_target_form {
+  /// An absolute path and optional query, e.g. `/path?q=1`
+  origin_form,
+  /// An absolute URL, e.g. `http://example.com/path`
+  absolute_form,
+  /// A host and port, used by `CONNECT`, e.g. `example.com:443`
+  authority_form,
+  /// `*`, used by a server-wide `OPTIONS` request
+  asterisk_form,
+};
+
+/// An HTTP request target, parsed as a URL
+struct request_target {
+  /// The form of the request target
+  request_target_form form;
+  /// The URL of the requested resource
+  ///
+  /// For the authority and asterisk forms the path is empty.
+  url_record url;
+};
+
+/// Parses an HTTP request target and the request's Host header and
+/// returns a `url_record`
+///
+/// The request target and Host header are parsed where they are, so
+/// the URL doesn't need to be put back together before it is parsed.
+/// The Host header is parsed by the URL parser's host and port
+/// states, and an origin-form request target by its path and query
+/// states. The result is the same as
+/// `parse(std::string(scheme) + "://" + std::string(host) + std::string(target))`
+/// except that:
+///
+/// - the request target is not trimmed and tabs and newlines are not
+///   removed from it, because an HTTP parser has already split the
+///   request line on spaces. They are percent encoded instead, so
+///   `/a\t/b` has the path `/a%09/b` where `parse` gives `/a/b`.
+/// - the Host header is trimmed and tabs and newlines are removed from
+///   it, as `parse` does for its whole input, so a Host header of
+///   `" example.com "` is accepted where `parse` would fail.
+///
+/// The Host header is ignored for an absolute-form request target,
+/// and the request target is used, and trimmed, in its place for an
+/// authority-form request target.
+///
+/// \code
+/// auto target = skyr::parse_request_target("/search?q=url", "example.com:8080");
+/// // target.value().form == skyr::request_target_form::origin_form
+/// // target.value().url.host == "example.com", target.value().url.port == 8080
+/// \endcode
+///
+/// \param target The request target
+/// \param host The value of the Host header
+/// \param scheme The scheme of the connection, e.g. `"https"` for a
+///        request received over TLS
+/// \param alloc The allocator used by the returned record
+/// \returns The parsed request target on success and an error code
+///          on failure
+expected<request_target, std::error_code> parse_request_target(
+    std::string_view target,
+    std::string_view host,
+    std::string_view scheme = "http",
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+}  // namespace skyr
+
+#endif  // SKYR_URL_REQUEST_TARGET_INC
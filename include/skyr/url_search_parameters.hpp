@@ -10,10 +10,13 @@
 #include <string_view>
 #include <vector>
 #include <functional>
+#include <memory_resource>
 #include <skyr/optional.hpp>
 #include <skyr/url_record.hpp>
 
 namespace skyr {
+class url;
+
 /// Supports iterating through
 /// [URL search parameters](https://url.spec.whatwg.org/#urlsearchparams)
 ///
@@ -23,64 +26,82 @@ class url_search_parameters {
 
  public:
 
+  /// The allocator used for the parameter names and values
+  using allocator_type = url_record::allocator_type;
+
   /// ASCII string type
   /// \sa url::string_type
-  using string_type = std::string;
+  using string_type = std::pmr::string;
 
   /// A key-value pair
   using value_type = std::pair<string_type, string_type>;
 
   /// An iterator through the search parameters
-  using const_iterator = std::vector<value_type>::const_iterator;
+  using const_iterator = std::pmr::vector<value_type>::const_iterator;
 
   /// Constructor
   url_search_parameters();
 
+  /// Constructor
+  ///
+  /// \param alloc The allocator used for the parameters
+  explicit url_search_parameters(const allocator_type &alloc);
+
   /// Constructor
   ///
   /// \param query The search string
-  explicit url_search_parameters(std::string_view query);
+  /// \param alloc The allocator used for the parameters
+  explicit url_search_parameters(
+      std::string_view query,
+      const allocator_type &alloc = allocator_type());
 
   /// Constructor
   ///
+  /// The parameters use the same allocator as `url`
+  ///
   /// \param url The URL record
   explicit url_search_parameters(url_record &url);
 
+  /// \returns The allocator used for the parameters
+  allocator_type get_allocator() const noexcept {
+    return parameters_.get_allocator();
+  }
+
   /// Appends a name-value pair to the search string
   ///
   /// \param name The parameter name
   /// \param value The parameter value
-  void append(const string_type &name, const string_type &value);
+  void append(std::string_view name, std::string_view value);
 
   /// Removes a parameter from the search string
   ///
   /// \param name The name of the parameter to remove
-  void remove(const string_type &name);
+  void remove(std::string_view name);
 
   ///
   ///
   /// \param name
   /// \returns
-  optional<string_type> get(const string_type &name) const noexcept;
+  optional<string_type> get(std::string_view name) const;
 
   ///
   ///
   /// \param name
   /// \returns
-  std::vector<string_type> get_all(const string_type &name) const;
+  std::vector<string_type> get_all(std::string_view name) const;
 
   /// Tests if there is a parameter with the given name
   ///
   /// \param name The search parameter name
   /// \returns `true` if the value is in the search parameters,
   /// `false` otherwise.
-  bool contains(const string_type &name) const noexcept;
+  bool contains(std::string_view name) const noexcept;
 
   /// Sets a URL search parameter
   ///
   /// \param name
   /// \param value
-  void set(const string_type &name, const string_type &value);
+  void set(std::string_view name, std::string_view value);
 
   /// Clears the search parameters
   ///
@@ -113,11 +134,16 @@ class url_search_parameters {
   string_type to_string() const;
 
  private:
+  friend class url;
+
+  url_search_parameters(url_record &record, url *owner);
+
   void initialize(std::string_view query);
   void update();
 
-  std::vector<value_type> parameters_;
+  std::pmr::vector<value_type> parameters_;
   optional<std::reference_wrapper<url_record>> url_;
+  url *owner_ = nullptr;
 };
 }  // namespace skyr
 
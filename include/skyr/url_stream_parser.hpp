@@ -0,0 +1,169 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_STREAM_PARSER_INC
+#define SKYR_URL_STREAM_PARSER_INC
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <skyr/optional.hpp>
+#include <skyr/expected.hpp>
+#include <skyr/url_record.hpp>
+#include <skyr/url_parse.hpp>
+
+namespace skyr {
+/// Parses a URL that arrives in chunks, for example a request target
+/// that is split across network buffers
+///
+/// The result is the same as calling `parse` on the concatenated
+/// chunks, wherever the chunks are split. Only the scheme and the
+/// authority are buffered, because the parser may need to read them
+/// again; the path, query and fragment are parsed straight from
+/// each chunk.
+///
+/// \code
+/// auto parser = skyr::url_stream_parser{};
+/// parser.feed("https://exam");
+/// parser.feed("ple.com/a?q");
+/// auto url = parser.finish();
+/// \endcode
+class url_stream_parser {
+ public:
+
+  /// The allocator used for the parsed record
+  using allocator_type = url_record::allocator_type;
+
+  /// Constructor
+  ///
+  /// \param base An optional base URL
+  /// \param alloc The allocator used for the parsed record
+  explicit url_stream_parser(
+      optional<url_record> base = nullopt,
+      const allocator_type &alloc = allocator_type());
+
+  /// Move constructor
+  url_stream_parser(url_stream_parser &&other) noexcept;
+
+  /// Move assignment operator
+  url_stream_parser &operator = (url_stream_parser &&other) noexcept;
+
+  /// Destructor
+  ~url_stream_parser();
+
+  /// Parses the next chunk of input
+  ///
+  /// \param chunk The next chunk, which need not outlive the call
+  /// \returns An error as soon as the input so far can't be the
+  ///          start of a valid URL; later calls and `finish` return
+  ///          the same error
+  expected<void, std::error_code> feed(std::string_view chunk);
+
+  /// Parses the end of the input
+  ///
+  /// The parser is then ready for a new URL with the same base.
+  ///
+  /// \returns A `url_record` on success and an error code on failure
+  expected<url_record, std::error_code> finish();
+
+ private:
+
+  struct impl;
+  std::unique_ptr<impl> impl_;
+};
+
+namespace details {
+/// Segments up to this total size are copied into a buffer on the
+/// stack and parsed by `parse`, which is faster than parsing them
+/// one after another because the fast path needs the whole input
+constexpr std::size_t max_gathered_segments_size = 2048;
+}  // namespace details
+
+/// Parses a URL that is split into segments, such as a URL that
+/// wraps around the end of a ring buffer, without copying the
+/// segments into a temporary string
+///
+/// The result is the same as calling `parse` on the concatenated
+/// segments. A single non-empty segment is parsed where it is, and
+/// short URLs are gathered into a buffer on the stack. Longer URLs
+/// are parsed as with `url_stream_parser`, so that only the scheme
+/// and the authority are copied.
+///
+/// \code
+/// auto ring = std::string_view("ple.com/a?qhttps://exam");
+/// auto segments = {ring.substr(11), ring.substr(0, 11)};
+/// auto url = skyr::parse_segments(segments);
+/// \endcode
+///
+/// \param first An iterator to the first segment
+/// \param last An iterator past the last segment
+/// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
+/// \returns A `url_record` on success and an error code on failure
+template <class InputIterator>
+expected<url_record, std::error_code> parse_segments(
+    InputIterator first, InputIterator last,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type()) {
+  using category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    auto segment = std::string_view();
+    auto count = std::size_t{0};
+    auto size = std::size_t{0};
+    for (auto it = first; it != last; ++it) {
+      auto view = std::string_view(*it);
+      if (!view.empty()) {
+        segment = view;
+        ++count;
+        size += view.size();
+      }
+    }
+    if (count < 2) {
+      return parse(segment, base, alloc);
+    }
+
+    if (size <= details::max_gathered_segments_size) {
+      std::array<char, details::max_gathered_segments_size> buffer;
+      auto out = buffer.data();
+      for (auto it = first; it != last; ++it) {
+        auto view = std::string_view(*it);
+        out = std::copy(begin(view), end(view), out);
+      }
+      return parse(std::string_view(buffer.data(), size), base, alloc);
+    }
+  }
+
+  auto parser = url_stream_parser(base, alloc);
+  for (auto it = first; it != last; ++it) {
+    auto result = parser.feed(std::string_view(*it));
+    if (!result) {
+      auto error = result.error();
+      return make_unexpected(std::move(error));
+    }
+  }
+  return parser.finish();
+}
+
+/// Parses a URL that is split into a range of segments
+///
+/// \param segments A range of segments
+/// \param base An optional base URL
+/// \param alloc The allocator used by the returned record
+/// \returns A `url_record` on success and an error code on failure
+template <class InputRange>
+expected<url_record, std::error_code> parse_segments(
+    const InputRange &segments,
+    const optional<url_record> &base = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type()) {
+  return parse_segments(std::begin(segments), std::end(segments), base, alloc);
+}
+}  // namespace skyr
+
+#endif  // SKYR_URL_STREAM_PARSER_INC
@@ -0,0 +1,145 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_VALIDATION_POLICY_INC
+#define SKYR_URL_VALIDATION_POLICY_INC
+
+#include <cstddef>
+#include <system_error>
+#include <vector>
+#include <skyr/optional.hpp>
+#include <skyr/url_error.hpp>
+#include <skyr/url_record.hpp>
+
+namespace skyr {
+/// A validation error, and where it was found
+struct url_validation_error {
+  /// The validation error
+  url_validation_errc code;
+  /// The offset of the byte at which the error was found, in the
+  /// input after leading and trailing C0 control or space
+  /// characters, tabs and newlines have been removed
+  std::size_t offset;
+};
+
+/// The parser's default validation policy, which sets
+/// `url_record::validation_error` if the input has any validation
+/// errors
+///
+/// A validation policy is told about each validation error by
+/// `report`, and the parser stops with `error()` once `failed()`
+/// returns `true`. If `reports_errors` is `false`, the parser skips
+/// the checks that only look for validation errors.
+class flag_validation_errors {
+ public:
+  /// `true` if `report` needs to be called
+  static constexpr bool reports_errors = true;
+
+  /// Called for each validation error
+  ///
+  /// \param url The record being parsed
+  /// \param code The validation error
+  /// \param offset Where the error was found
+  void report(url_record &url, url_validation_errc code, std::size_t offset) noexcept {
+    url.validation_error = true;
+  }
+
+  /// \returns `true` if the parser must stop
+  constexpr bool failed() const noexcept {
+    return false;
+  }
+
+  /// \returns The error returned by the parser if it stops
+  std::error_code error() const noexcept {
+    return std::error_code();
+  }
+};
+
+/// A validation policy that discards validation errors, so that
+/// `url_record::validation_error` is never set
+class ignore_validation_errors {
+ public:
+  /// `false`, so the parser doesn't look for validation errors
+  static constexpr bool reports_errors = false;
+
+  /// Called for each validation error, and does nothing
+  void report(url_record &, url_validation_errc, std::size_t) noexcept {}
+
+  /// \returns `false`
+  constexpr bool failed() const noexcept {
+    return false;
+  }
+
+  /// \returns An empty error code
+  std::error_code error() const noexcept {
+    return std::error_code();
+  }
+};
+
+/// A validation policy that fails on the first validation error, for
+/// inputs that must be valid URL strings
+class fail_on_validation_error {
+ public:
+  /// `true` if `report` needs to be called
+  static constexpr bool reports_errors = true;
+
+  /// Records the first validation error
+  void report(url_record &url, url_validation_errc code, std::size_t offset) noexcept {
+    url.validation_error = true;
+    if (!error_) {
+      error_ = code;
+    }
+  }
+
+  /// \returns `true` once a validation error has been found
+  bool failed() const noexcept {
+    return static_cast<bool>(error_);
+  }
+
+  /// \returns The first validation error
+  std::error_code error() const noexcept {
+    return error_? make_error_code(error_.value()) : std::error_code();
+  }
+
+ private:
+  optional<url_validation_errc> error_;
+};
+
+/// A validation policy that collects every validation error with its
+/// offset, which is useful for tools that explain why a URL is not
+/// valid
+class collect_validation_errors {
+ public:
+  /// `true` if `report` needs to be called
+  static constexpr bool reports_errors = true;
+
+  /// Appends the validation error to the list
+  void report(url_record &url, url_validation_errc code, std::size_t offset) {
+    url.validation_error = true;
+    errors_.push_back(url_validation_error{code, offset});
+  }
+
+  /// \returns `false`
+  constexpr bool failed() const noexcept {
+    return false;
+  }
+
+  /// \returns An empty error code
+  std::error_code error() const noexcept {
+    return std::error_code();
+  }
+
+  /// \returns The validation errors, in the order in which they were
+  ///          found
+  const std::vector<url_validation_error> &errors() const noexcept {
+    return errors_;
+  }
+
+ private:
+  std::vector<url_validation_error> errors_;
+};
+}  // namespace skyr
+
+#endif  // SKYR_URL_VALIDATION_POLICY_INC
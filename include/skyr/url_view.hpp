@@ -0,0 +1,183 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_VIEW_INC
+#define SKYR_URL_VIEW_INC
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <skyr/optional.hpp>
+#include <skyr/expected.hpp>
+#include <skyr/url_record.hpp>
+#include <skyr/details/url_components.hpp>
+
+namespace skyr {
+/// A validated URL whose components refer into the caller's buffer
+///
+/// When the input is already in its serialized form, a `url_view`
+/// borrows it and makes no copy. Otherwise it owns the serialized
+/// URL, and its components refer into that. In both cases the
+/// components are the same as those of the corresponding `url`.
+///
+/// A `url_view` that borrows its input must not outlive it.
+class url_view {
+
+ public:
+
+  /// ASCII string type
+  using string_type = std::string;
+  /// A view into the serialized URL
+  using string_view = std::string_view;
+  /// A forward iterator over the path segments
+  using path_iterator = details::url_path_iterator;
+
+  /// Constructs an empty view
+  url_view() = default;
+
+  /// \returns The serialized URL
+  string_view href() const noexcept {
+    return storage_.empty()? input_ : string_view(storage_);
+  }
+
+  /// \returns `true` if the components refer into the input, and
+  ///          `false` if the URL needed normalizing and was copied
+  bool borrows_input() const noexcept {
+    return storage_.empty();
+  }
+
+  /// \returns The URL scheme, without the trailing `":"`
+  string_view scheme() const noexcept {
+    return components_.view(href(), components::scheme_index);
+  }
+
+  /// \returns The URL username
+  string_view username() const noexcept {
+    return components_.view(href(), components::username_index);
+  }
+
+  /// \returns The URL password
+  string_view password() const noexcept {
+    return components_.view(href(), components::password_index);
+  }
+
+  /// \returns The serialized host, or `nullopt` if there is none
+  optional<string_view> host() const noexcept {
+    return components_.optional_view(
+        href(), components::host_index, components::has_host_flag);
+  }
+
+  /// \returns The URL port, or `nullopt` if there is none
+  optional<std::uint16_t> port() const noexcept {
+    if (!components_.has(components::has_port_flag)) {
+      return nullopt;
+    }
+    return components_.port;
+  }
+
+  /// \returns The serialized path, as returned by `url::pathname()`
+  string_view pathname() const noexcept {
+    return components_.view(href(), components::path_index);
+  }
+
+  /// \returns The URL query, without the leading `"?"`, or `nullopt`
+  ///          if there is none
+  optional<string_view> query() const noexcept {
+    return components_.optional_view(
+        href(), components::query_index, components::has_query_flag);
+  }
+
+  /// \returns The URL query with a leading `"?"`, as returned by
+  ///          `url::search()`
+  string_view search() const noexcept {
+    return components_.view_with_delimiter(href(), components::query_index);
+  }
+
+  /// \returns The URL fragment, without the leading `"#"`, or
+  ///          `nullopt` if there is none
+  optional<string_view> fragment() const noexcept {
+    return components_.optional_view(
+        href(), components::fragment_index, components::has_fragment_flag);
+  }
+
+  /// \returns The URL fragment with a leading `"#"`, as returned by
+  ///          `url::hash()`
+  string_view hash() const noexcept {
+    return components_.view_with_delimiter(href(), components::fragment_index);
+  }
+
+  /// \returns An iterator to the first path segment
+  path_iterator path_begin() const noexcept {
+    return path_iterator(pathname(), cannot_be_a_base_url());
+  }
+
+  /// \returns An iterator past the last path segment
+  path_iterator path_end() const noexcept {
+    return path_iterator();
+  }
+
+  /// \returns `true` if this URL cannot be used as a base URL
+  bool cannot_be_a_base_url() const noexcept {
+    return components_.has(components::cannot_be_a_base_url_flag);
+  }
+
+  /// \returns `true` if a non-fatal validation error occurred
+  ///          during parsing
+  bool validation_error() const noexcept {
+    return components_.has(components::validation_error_flag);
+  }
+
+  /// \returns `true` if the view is empty
+  bool empty() const noexcept {
+    return href().empty();
+  }
+
+  /// \returns A `url_record` with the same components
+  url_record to_record() const;
+
+  /// Swaps two `url_view` objects
+  /// \param other Another `url_view` object
+  void swap(url_view &other) noexcept;
+
+ private:
+
+  friend expected<url_view, std::error_code> make_url_view(
+      std::string_view input, const optional<url_record> &base);
+
+  using components = details::url_components;
+
+  string_view input_;
+  string_type storage_;
+  components components_;
+};
+
+/// Swaps two `url_view` objects
+///
+/// Equivalent to `lhs.swap(rhs)`
+///
+/// \param lhs A `url_view` object
+/// \param rhs A `url_view` object
+void swap(url_view &lhs, url_view &rhs) noexcept;
+
+/// Parses and validates a URL without copying it, if possible
+///
+/// Plain ASCII http(s) and ws(s) URLs in serialized form are
+/// borrowed without any allocation. Any other input is parsed with
+/// the full state machine into a small stack buffer, and is borrowed
+/// only if serializing the result gives back the input. Such inputs
+/// are usually borrowed without allocation too, but very long inputs
+/// and hosts that need IDNA processing still allocate.
+///
+/// \param input The input string, which must outlive the result if
+///        it is borrowed
+/// \param base An optional base URL
+/// \returns A `url_view` on success and an error code on failure
+expected<url_view, std::error_code> make_url_view(
+    std::string_view input,
+    const optional<url_record> &base = nullopt);
+}  // namespace skyr
+
+#endif  // SKYR_URL_VIEW_INC
@@ -6,11 +6,13 @@
 #ifndef SKYR_ALGORITHMS_HPP
 #define SKYR_ALGORITHMS_HPP
 
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <iterator>
 #include <algorithm>
 #include <vector>
-#include <locale>
+#include <skyr/details/char_class.hpp>
 
 namespace skyr {
 inline bool is_ascii(std::u32string_view input) noexcept {
@@ -87,45 +89,29 @@ inline bool is_in(
   return last != std::find(first, last, byte);
 }
 
-inline bool is_c0_control_or_whitespace(
-    char byte,
-    const std::locale &locale = std::locale::classic()) noexcept {
-  static const char c0_control[] = "\0\x1b\x04\x12\x1f";
-  return std::isspace(byte, locale) ||
-    is_in(byte, std::string_view(c0_control, sizeof(c0_control)));
+inline bool is_c0_control_or_whitespace(char byte) noexcept {
+  return details::is_in_class(byte, details::char_class::c0_control_or_space);
 }
 
-inline bool remove_leading_whitespace(std::string &input) {
-  auto view = std::string_view(input);
-  auto first = begin(view), last = end(view);
+inline bool remove_leading_whitespace(std::string_view &input) noexcept {
+  auto first = begin(input), last = end(input);
   auto it = std::find_if(
       first, last,
       [] (auto byte) -> bool {
         return !is_c0_control_or_whitespace(byte);
       });
-  if (it != first) {
-    input.assign(it, last);
-  }
-
+  input.remove_prefix(std::distance(first, it));
   return it == first;
 }
 
-inline bool remove_trailing_whitespace(std::string &input) {
-  using reverse_iterator =
-      std::reverse_iterator<std::string::const_iterator>;
-
-  auto first = reverse_iterator(end(input)),
-      last = reverse_iterator(begin(input));
+inline bool remove_trailing_whitespace(std::string_view &input) noexcept {
+  auto first = input.rbegin(), last = input.rend();
   auto it = std::find_if(
       first, last,
       [] (auto byte) -> bool {
         return !is_c0_control_or_whitespace(byte);
       });
-  if (it != first) {
-    input = std::string(it, last);
-    std::reverse(begin(input), end(input));
-  }
-
+  input.remove_suffix(std::distance(first, it));
   return it == first;
 }
 }  // namespace skyr
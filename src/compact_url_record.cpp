@@ -0,0 +1,79 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <utility>
+#include "skyr/compact_url_record.hpp"
+#include "skyr/url_parse.hpp"
+#include "url_fast_parse.hpp"
+#include "url_components_builder.hpp"
+
+namespace skyr {
+compact_url_record::compact_url_record() = default;
+
+compact_url_record::compact_url_record(const url_record &record) {
+  details::build_url_components(record, href_, components_);
+}
+
+optional<compact_url_record::string_view> compact_url_record::host() const noexcept {
+  return components_.optional_view(
+      href_, components::host_index, components::has_host_flag);
+}
+
+optional<std::uint16_t> compact_url_record::port() const noexcept {
+  if (!components_.has(components::has_port_flag)) {
+    return nullopt;
+  }
+  return components_.port;
+}
+
+optional<compact_url_record::string_view> compact_url_record::query() const noexcept {
+  return components_.optional_view(
+      href_, components::query_index, components::has_query_flag);
+}
+
+compact_url_record::string_view compact_url_record::search() const noexcept {
+  return components_.view_with_delimiter(href_, components::query_index);
+}
+
+optional<compact_url_record::string_view> compact_url_record::fragment() const noexcept {
+  return components_.optional_view(
+      href_, components::fragment_index, components::has_fragment_flag);
+}
+
+compact_url_record::string_view compact_url_record::hash() const noexcept {
+  return components_.view_with_delimiter(href_, components::fragment_index);
+}
+
+url_record compact_url_record::to_record() const {
+  return details::make_url_record(href_, components_);
+}
+
+void compact_url_record::swap(compact_url_record &other) noexcept {
+  using std::swap;
+  swap(href_, other.href_);
+  swap(components_, other.components_);
+}
+
+void swap(compact_url_record &lhs, compact_url_record &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+expected<compact_url_record, std::error_code> parse_compact(
+    std::string_view input,
+    const optional<url_record> &base) {
+  auto fast_url = details::fast_parse(input);
+  if (fast_url) {
+    auto result = compact_url_record{};
+    details::build_url_components(fast_url.value(), result.href_, result.components_);
+    return result;
+  }
+
+  auto url = parse(input, base);
+  if (!url) {
+    return make_unexpected(std::move(url.error()));
+  }
+  return compact_url_record(url.value());
+}
+}  // namespace skyr
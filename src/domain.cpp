@@ -6,6 +6,7 @@
 #include <cstring>
 #include <algorithm>
 #include <vector>
+#include <limits>
 #include "skyr/unicode.hpp"
 #include "skyr/domain.hpp"
 #include "algorithms.hpp"
@@ -84,6 +85,63 @@ std::string to_ascii(std::string input) {
 inline bool delim(char32_t c) {
   return c == delimiter;
 }
+
+/// A Fenwick tree over the positions in a label, used to count or
+/// find marked positions in logarithmic time, so that encoding and
+/// decoding don't have to rescan or shift the whole label for each
+/// code point
+class position_counter {
+ public:
+  position_counter(std::size_t size, bool marked)
+    : tree_(size + 1, 0) {
+    if (marked) {
+      for (auto position = std::size_t(1); position < tree_.size(); ++position) {
+        tree_[position] = static_cast<int>(lowest_bit(position));
+      }
+    }
+  }
+
+  void add(std::size_t position, int value) noexcept {
+    for (++position; position < tree_.size(); position += lowest_bit(position)) {
+      tree_[position] += value;
+    }
+  }
+
+  /// \returns The number of marked positions before `last`
+  std::size_t count(std::size_t last) const noexcept {
+    auto result = 0;
+    for (; last > 0; last -= lowest_bit(last)) {
+      result += tree_[last];
+    }
+    return static_cast<std::size_t>(result);
+  }
+
+  /// \returns The position of the marked position with the given
+  ///          zero-based rank
+  std::size_t find(std::size_t rank) const noexcept {
+    auto position = std::size_t(0);
+    auto step = std::size_t(1);
+    while ((step << 1) < tree_.size()) {
+      step <<= 1;
+    }
+
+    for (; step > 0; step >>= 1) {
+      auto next = position + step;
+      if ((next < tree_.size()) && (static_cast<std::size_t>(tree_[next]) <= rank)) {
+        position = next;
+        rank -= tree_[next];
+      }
+    }
+    return position;
+  }
+
+ private:
+  static std::size_t lowest_bit(std::size_t value) noexcept {
+    return value & (~value + 1);
+  }
+
+  std::vector<int> tree_;
+};
 }  // namespace
 
 expected<std::string, std::error_code> punycode_encode(std::string_view input) {
@@ -115,47 +173,68 @@ expected<std::string, std::error_code> punycode_encode(std::u32string_view input
     result += delimiter;
   }
 
-  while (h < input.size()) {
-    auto m = std::numeric_limits<char32_t>::max();
-    for (auto c : input) {
-      if ((c >= n) && (c < m)) {
-        m = c;
-      }
+  // Each code point is handled in order of value, and `handled`
+  // marks the positions of the code points that are less than `n`
+  auto code_points = std::vector<std::pair<char32_t, std::size_t>>{};
+  auto handled = position_counter(input.size(), false);
+  for (auto position = std::size_t(0); position < input.size(); ++position) {
+    if (input[position] < 0x80) {
+      handled.add(position, 1);
+    } else {
+      code_points.emplace_back(input[position], position);
     }
+  }
+  std::sort(begin(code_points), end(code_points));
 
+  auto first = begin(code_points), last = end(code_points);
+  while (first != last) {
+    auto m = first->first;
     if ((m - n) > ((std::numeric_limits<char32_t>::max() - delta) / (h + 1))) {
       return make_unexpected(make_error_code(domain_errc::overflow));
     }
     delta += (m - n) * (h + 1);
     n = m;
 
-    for (auto c : input) {
-      if (c < n) {
-        if (++delta == 0) {
-          return make_unexpected(make_error_code(domain_errc::overflow));
+    auto group_last = std::find_if(
+        first, last, [n](const auto &code_point) { return code_point.first != n; });
+    auto previous = std::size_t(0);
+    for (auto it = first; it != group_last; ++it) {
+      auto count = handled.count(it->second) - handled.count(previous);
+      if (count > (std::numeric_limits<char32_t>::max() - delta)) {
+        return make_unexpected(make_error_code(domain_errc::overflow));
+      }
+      delta += static_cast<char32_t>(count);
+
+      auto q = delta;
+      auto k = uint32_t(base);
+      while (true) {
+        auto t = k <= bias ? tmin :
+                 k >= bias + tmax ? tmax : k - bias;
+        if (q < t) {
+          break;
         }
+        result += encode_digit(t + (q - t) % (base - t), 0);
+        q = (q - t) / (base - t);
+        k += base;
       }
 
-      if (c == n) {
-        auto q = delta;
-        auto k = uint32_t(base);
-        while (true) {
-          auto t = k <= bias ? tmin :
-                   k >= bias + tmax ? tmax : k - bias;
-          if (q < t) {
-            break;
-          }
-          result += encode_digit(t + (q - t) % (base - t), 0);
-          q = (q - t) / (base - t);
-          k += base;
-        }
+      result += encode_digit(q, 0);
+      bias = adapt(delta, (h + 1), (h == b));
+      delta = 0;
+      ++h;
+      previous = it->second + 1;
+    }
 
-        result += encode_digit(q, 0);
-        bias = adapt(delta, (h + 1), (h == b));
-        delta = 0;
-        ++h;
-      }
+    auto count = handled.count(input.size()) - handled.count(previous);
+    if (count > (std::numeric_limits<char32_t>::max() - delta)) {
+      return make_unexpected(make_error_code(domain_errc::overflow));
     }
+    delta += static_cast<char32_t>(count);
+
+    for (auto it = first; it != group_last; ++it) {
+      handled.add(it->second, 1);
+    }
+    first = group_last;
 
     ++delta, ++n;
   }
@@ -164,9 +243,6 @@ expected<std::string, std::error_code> punycode_encode(std::u32string_view input
 }
 
 expected<std::string, std::error_code> punycode_decode(std::string_view input) {
-  auto result = std::u32string();
-  result.reserve(256);
-
   if (input.substr(0, 4).compare("xn--") == 0) {
     input.remove_prefix(4);
   } else {
@@ -183,9 +259,10 @@ expected<std::string, std::error_code> punycode_decode(std::string_view input) {
     }
   }
 
-  for (auto j = 0U; j < basic; ++j) {
-    result += input[j];
-  }
+  // The decoded code points are recorded with the position at which
+  // they're inserted, and are only put in place at the end
+  auto insertions = std::vector<std::pair<char32_t, char32_t>>{};
+  auto length = static_cast<char32_t>(basic);
 
   auto in = static_cast<char32_t>((basic > 0U) ? (basic + 1U) : 0U);
   auto i = static_cast<char32_t>(0U);
@@ -218,7 +295,7 @@ expected<std::string, std::error_code> punycode_decode(std::string_view input) {
       k += base;
     }
 
-    auto out = static_cast<char32_t>(result.size() + 1U);
+    auto out = static_cast<char32_t>(length + 1U);
     bias = adapt((i - oldi), out, (oldi == 0U));
 
     if ((i / out) > (std::numeric_limits<char32_t>::max() - n)) {
@@ -227,7 +304,28 @@ expected<std::string, std::error_code> punycode_decode(std::string_view input) {
     n += i / out;
     i %= out;
 
-    result.insert(i++, 1, n);
+    insertions.emplace_back(i++, n);
+    ++length;
+  }
+
+  // Going backwards, each code point takes the free slot whose rank
+  // is its insert position, and the basic code points fill the rest
+  auto result = std::u32string(length, U'\0');
+  auto filled = std::vector<bool>(length, false);
+  auto free_slots = position_counter(length, true);
+
+  for (auto it = insertions.rbegin(); it != insertions.rend(); ++it) {
+    auto slot = free_slots.find(it->first);
+    result[slot] = it->second;
+    filled[slot] = true;
+    free_slots.add(slot, -1);
+  }
+
+  auto j = 0U;
+  for (auto slot = std::size_t(0); slot < length; ++slot) {
+    if (!filled[slot]) {
+      result[slot] = input[j++];
+    }
   }
 
   auto bytes = utf32_to_bytes(result);
@@ -360,6 +458,18 @@ expected<std::string, std::error_code> unicode_to_ascii(
 expected<std::string, std::error_code> domain_to_ascii(
     std::string_view domain,
     bool be_strict) {
+  // These code points are all valid and map to themselves, so a
+  // domain that only uses them is already in its ASCII form
+  auto is_ascii_domain = std::all_of(
+      begin(domain), end(domain), [](auto byte) -> bool {
+        return ((byte >= 'a') && (byte <= 'z')) ||
+               ((byte >= '0') && (byte <= '9')) ||
+               (byte == '-') || (byte == '.');
+      });
+  if (is_ascii_domain) {
+    return std::string(domain);
+  }
+
   auto utf32 = utf32_from_bytes(domain);
   if (!utf32) {
     return make_unexpected(
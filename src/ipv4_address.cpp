@@ -5,12 +5,12 @@
 
 #include <cstdint>
 #include <cmath>
-#include <locale>
-#include <vector>
+#include <array>
 #include <sstream>
 #include <algorithm>
 #include <skyr/optional.hpp>
 #include "skyr/ipv4_address.hpp"
+#include "skyr/details/char_class.hpp"
 
 namespace skyr {
 namespace {
@@ -54,7 +54,7 @@ expected<std::uint64_t, std::error_code> parse_ipv4_number(
 
   if (
     (input.size() >= 2) && (input[0] == '0') &&
-    (std::tolower(input[1], std::locale::classic()) == 'x')) {
+    (details::to_ascii_lower(input[1]) == 'x')) {
     input = input.substr(2);
     base = 16;
   } else if ((input.size() >= 2) && (input[0] == '0')) {
@@ -66,6 +66,19 @@ expected<std::uint64_t, std::error_code> parse_ipv4_number(
     return 0ULL;
   }
 
+  // Most hosts are domain names, so reject non-digits before
+  // `std::stoull` gets a chance to throw
+  auto is_digit = [base] (auto byte) -> bool {
+    if (base == 16) {
+      return details::is_in_class(byte, details::char_class::hex_digit);
+    }
+    return (byte >= '0') && (byte < static_cast<char>('0' + base));
+  };
+  if (!std::all_of(begin(input), end(input), is_digit)) {
+    return make_unexpected(
+        make_error_code(ipv4_address_errc::invalid_segment_number));
+  }
+
   try {
     auto pos = static_cast<std::size_t>(0);
     auto number = std::stoull(std::string(input), &pos, base);
@@ -84,16 +97,14 @@ expected<std::uint64_t, std::error_code> parse_ipv4_number(
 
 std::string ipv4_address::to_string() const {
   auto output = std::string();
+  output.reserve(15);
 
-  auto n = address_;
-  for (auto i = 1U; i <= 4U; ++i) {
-    output = std::to_string(n % 256) + output;
+  for (auto shift = 24; shift >= 0; shift -= 8) {
+    output += std::to_string((address_ >> shift) & 0xffU);
 
-    if (i != 4) {
-      output = "." + output;
+    if (shift != 0) {
+      output += '.';
     }
-
-    n = static_cast<std::uint32_t>(std::floor(n / 256.));
   }
 
   return output;
@@ -105,24 +116,36 @@ std::pair<expected<ipv4_address, std::error_code>, bool> parse_ipv4_address(std:
   auto validation_error_flag = false;
   auto validation_error = false;
 
-  std::vector<std::string> parts;
-  parts.emplace_back();
-  for (auto ch : input) {
-    if (ch == '.') {
-      parts.emplace_back();
-    } else {
-      parts.back().push_back(ch);
+  // At most five segments are meaningful: four, plus a trailing empty
+  // one.  Any more and the input is rejected, so the segments are views
+  // into `input` held in fixed storage
+  auto parts = std::array<std::string_view, 5>();
+  auto part_count = std::size_t(1);
+  auto part_first = std::size_t(0);
+  for (auto i = std::size_t(0); i < input.size(); ++i) {
+    if (input[i] == '.') {
+      if (part_count == parts.size()) {
+        return
+          std::make_pair(
+              make_unexpected(
+                  make_error_code(
+                      ipv4_address_errc::too_many_segments)), true);
+      }
+      parts[part_count - 1] = input.substr(part_first, i - part_first);
+      part_first = i + 1;
+      ++part_count;
     }
   }
+  parts[part_count - 1] = input.substr(part_first);
 
-  if (parts.back().empty()) {
+  if (parts[part_count - 1].empty()) {
     validation_error_flag = true;
-    if (parts.size() > 1) {
-      parts.pop_back();
+    if (part_count > 1) {
+      --part_count;
     }
   }
 
-  if (parts.size() > 4) {
+  if (part_count > 4) {
     return
       std::make_pair(
           make_unexpected(
@@ -130,9 +153,11 @@ std::pair<expected<ipv4_address, std::error_code>, bool> parse_ipv4_address(std:
                   ipv4_address_errc::too_many_segments)), true);
   }
 
-  auto numbers = std::vector<std::uint64_t>();
+  auto number_storage = std::array<std::uint64_t, 4>();
+  auto number_count = std::size_t(0);
 
-  for (const auto &part : parts) {
+  for (auto part_it = begin(parts); part_it != begin(parts) + part_count; ++part_it) {
+    const auto &part = *part_it;
     if (part.empty()) {
       return
         std::make_pair(
@@ -141,7 +166,7 @@ std::pair<expected<ipv4_address, std::error_code>, bool> parse_ipv4_address(std:
                     ipv4_address_errc::empty_segment)), true);
     }
 
-    auto number = parse_ipv4_number(std::string_view(part), validation_error_flag);
+    auto number = parse_ipv4_number(part, validation_error_flag);
     if (!number) {
       return
         std::make_pair(
@@ -150,14 +175,14 @@ std::pair<expected<ipv4_address, std::error_code>, bool> parse_ipv4_address(std:
                     ipv4_address_errc::invalid_segment_number)), validation_error_flag);
     }
 
-    numbers.push_back(number.value());
+    number_storage[number_count++] = number.value();
   }
 
   if (validation_error_flag) {
     validation_error = true;
   }
 
-  auto numbers_first = begin(numbers), numbers_last = end(numbers);
+  auto numbers_first = begin(number_storage), numbers_last = numbers_first + number_count;
 
   auto numbers_it =
       std::find_if(numbers_first, numbers_last,
@@ -178,20 +203,19 @@ std::pair<expected<ipv4_address, std::error_code>, bool> parse_ipv4_address(std:
               make_error_code(ipv4_address_errc::overflow)), true);
   }
 
-  if (numbers.back() >=
-      static_cast<std::uint64_t>(std::pow(256, 5 - numbers.size()))) {
+  if (*numbers_last_but_one >=
+      static_cast<std::uint64_t>(std::pow(256, 5 - number_count))) {
     return
       std::make_pair(
           make_unexpected(
               make_error_code(ipv4_address_errc::overflow)), true);
   }
 
-  auto ipv4 = numbers.back();
-  numbers.pop_back();
+  auto ipv4 = *numbers_last_but_one;
 
   auto counter = 0UL;
-  for (auto number : numbers) {
-    ipv4 += number * static_cast<std::uint64_t>(std::pow(256, 3 - counter));
+  for (auto number_it = numbers_first; number_it != numbers_last_but_one; ++number_it) {
+    ipv4 += *number_it * static_cast<std::uint64_t>(std::pow(256, 3 - counter));
     ++counter;
   }
 
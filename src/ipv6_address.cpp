@@ -7,10 +7,10 @@
 #include <vector>
 #include <cassert>
 #include <cstring>
-#include <locale>
 #include <algorithm>
 #include "skyr/optional.hpp"
 #include "skyr/ipv6_address.hpp"
+#include "skyr/details/char_class.hpp"
 #include "algorithms.hpp"
 
 namespace skyr {
@@ -51,15 +51,8 @@ std::error_code make_error_code(ipv6_address_errc error) {
 
 namespace {
 inline std::uint16_t hex_to_dec(char byte) noexcept {
-  assert(std::isxdigit(byte, std::locale::classic()));
-
-  auto byte_lower = std::tolower(byte, std::locale::classic());
-
-  if (std::isdigit(byte_lower, std::locale::classic())) {
-    return static_cast<std::uint16_t>(byte_lower - '0');
-  }
-
-  return static_cast<std::uint16_t>(byte_lower - 'a') + 10;
+  assert(details::is_in_class(byte, details::char_class::hex_digit));
+  return details::hex_digit_value(byte);
 }
 }  // namespace
 
@@ -198,7 +191,7 @@ std::pair<expected<ipv6_address, std::error_code>, bool> parse_ipv6_address(std:
 
     while (
         (it != last) &&
-            ((length < 4) && std::isxdigit(*it, std::locale::classic()))) {
+            ((length < 4) && details::is_in_class(*it, details::char_class::hex_digit))) {
       value = value * 0x10 + hex_to_dec(*it);
       ++it;
       ++length;
@@ -239,7 +232,7 @@ std::pair<expected<ipv6_address, std::error_code>, bool> parse_ipv6_address(std:
           }
         }
 
-        if ((it == last) || !std::isdigit(*it, std::locale::classic())) {
+        if ((it == last) || !details::is_in_class(*it, details::char_class::digit)) {
           return
               std::make_pair(
                   make_unexpected(
@@ -247,7 +240,7 @@ std::pair<expected<ipv6_address, std::error_code>, bool> parse_ipv6_address(std:
                           ipv6_address_errc::invalid_ipv4_segment_number)), true);
         }
 
-        while ((it != last) && std::isdigit(*it, std::locale::classic())) {
+        while ((it != last) && details::is_in_class(*it, details::char_class::digit)) {
           auto number = static_cast<std::uint16_t>(*it - '0');
           if (!ipv4_piece) {
             ipv4_piece = number;
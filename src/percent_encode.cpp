@@ -155,28 +155,11 @@ expected<std::string, std::error_code> percent_decode(std::string_view input) {
 
 bool is_percent_encoded(
     std::string_view input,
-    const std::locale &locale) {
-  auto first = begin(input), last = end(input);
-  auto it = first;
-
-  if (it == last) {
-    return false;
-  }
-
-  if (*it == '%') {
-    ++it;
-    if (it != last) {
-      if (std::isxdigit(*it, locale)) {
-        ++it;
-        if (it != last) {
-          if (std::isxdigit(*it, locale)) {
-            return true;
-          }
-        }
-      }
-    }
-  }
-
-  return false;
+    const std::locale &) {
+  return
+      (input.size() >= 3) &&
+      (input[0] == '%') &&
+      details::is_in_class(input[1], details::char_class::hex_digit) &&
+      details::is_in_class(input[2], details::char_class::hex_digit);
 }
 }  // namespace skyr
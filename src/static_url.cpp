@@ -0,0 +1,17 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "skyr/static_url.hpp"
+#include "url_fast_parse.hpp"
+
+namespace skyr {
+url_record static_url::to_record() const {
+  return details::make_url_record(details::fast_parse(href_).value());
+}
+
+url static_url::to_url() const {
+  return url(to_record());
+}
+}  // namespace skyr
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <functional>
 #include <locale>
+#include <utility>
 #include <vector>
 #include <cassert>
 #include "skyr/url.hpp"
@@ -14,30 +15,304 @@
 #include "skyr/url_serialize.hpp"
 #include "skyr/percent_encode.hpp"
 #include "url_parse_impl.hpp"
+#include "url_sections.hpp"
 #include "url_schemes.hpp"
 
 namespace skyr {
+namespace {
+using details::url_section;
+
+// Each of these applies the edit made by one of the setters to a URL
+// record, and leaves the record unchanged if it fails
+
+expected<void, std::error_code> edit_protocol(url_record &url, std::string_view protocol) {
+  auto input = std::string(protocol);
+  input += ":";
+  return details::basic_parse(input, url, url_parse_state::scheme_start);
+}
+
+expected<void, std::error_code> edit_userinfo(
+    url_record &url, url_record::string_type &userinfo, std::string_view value) {
+  if (url.cannot_have_a_username_password_or_port()) {
+    return make_unexpected(make_error_code(
+        url_parse_errc::cannot_have_a_username_password_or_port));
+  }
+
+  static const auto excludes = userinfo_set();
+  userinfo.clear();
+  for (auto c : value) {
+    auto pct_encoded = percent_encode_byte(c, excludes);
+    userinfo += pct_encoded;
+  }
+  return {};
+}
+
+expected<void, std::error_code> edit_username(url_record &url, std::string_view username) {
+  return edit_userinfo(url, url.username, username);
+}
+
+expected<void, std::error_code> edit_password(url_record &url, std::string_view password) {
+  return edit_userinfo(url, url.password, password);
+}
+
+expected<void, std::error_code> edit_host(url_record &url, std::string_view host) {
+  if (url.cannot_be_a_base_url) {
+    return make_unexpected(make_error_code(
+        url_parse_errc::cannot_be_a_base_url));
+  }
+  return details::basic_parse(host, url, url_parse_state::host);
+}
+
+expected<void, std::error_code> edit_hostname(url_record &url, std::string_view hostname) {
+  if (url.cannot_be_a_base_url) {
+    return make_unexpected(make_error_code(
+        url_parse_errc::cannot_be_a_base_url));
+  }
+  return details::basic_parse(hostname, url, url_parse_state::hostname);
+}
+
+expected<void, std::error_code> edit_port(url_record &url, std::string_view port) {
+  if (url.cannot_have_a_username_password_or_port()) {
+    return make_unexpected(make_error_code(
+        url_parse_errc::cannot_have_a_username_password_or_port));
+  }
+
+  if (port.empty()) {
+    url.port = nullopt;
+    return {};
+  }
+  return details::basic_parse(port, url, url_parse_state::port);
+}
+
+expected<void, std::error_code> edit_pathname(url_record &url, std::string_view pathname) {
+  if (url.cannot_be_a_base_url) {
+    return make_unexpected(make_error_code(
+        url_parse_errc::cannot_be_a_base_url));
+  }
+
+  auto path = url_path(url.path.get_allocator());
+  path.swap(url.path);
+  auto result = details::basic_parse(pathname, url, url_parse_state::path_start);
+  if (!result) {
+    path.swap(url.path);
+  }
+  return result;
+}
+
+expected<void, std::error_code> edit_search(url_record &url, std::string_view search) {
+  if (search.empty()) {
+    url.query = nullopt;
+    return {};
+  }
+
+  if (search.front() == '?') {
+    search.remove_prefix(1);
+  }
+
+  auto query = std::move(url.query);
+  url.query = url.make_string();
+  auto result = details::basic_parse(search, url, url_parse_state::query);
+  if (!result) {
+    url.query = std::move(query);
+  }
+  return result;
+}
+
+expected<void, std::error_code> edit_hash(url_record &url, std::string_view hash) {
+  if (hash.empty()) {
+    url.fragment = nullopt;
+    return {};
+  }
+
+  if (hash.front() == '#') {
+    hash.remove_prefix(1);
+  }
+
+  auto fragment = std::move(url.fragment);
+  url.fragment = url.make_string();
+  auto result = details::basic_parse(hash, url, url_parse_state::fragment);
+  if (!result) {
+    url.fragment = std::move(fragment);
+  }
+  return result;
+}
+
+/// \returns The characters of one section of the serialized URL
+std::string_view section_view(
+    std::string_view href, const url_record &url, url_section section) noexcept {
+  auto size = details::section_size(url, section);
+  if (size == 0) {
+    return {};
+  }
+
+  // The sections after the authority are found from the end of the
+  // href, so that the authority doesn't need to be measured
+  auto offset = (section <= url_section::authority)?
+      details::section_offset(url, section) :
+      href.size() - details::sections_size(url, section, url_section::fragment);
+  return href.substr(offset, size);
+}
+
+using edit_function = expected<void, std::error_code> (*)(url_record &, std::string_view);
+
+/// An edit, and the first and last sections of the href it can change
+struct section_edit {
+  edit_function edit;
+  url_section first;
+  url_section last;
+};
+
+/// A path edit on a file URL clears the host if the first segment
+/// is a Windows drive letter, so it can change the authority too
+section_edit pathname_edit(const url_record &url) noexcept {
+  auto first = (url.scheme.compare("file") == 0)? url_section::authority : url_section::path;
+  return section_edit{edit_pathname, first, url_section::path};
+}
+
+unsigned section_bit(url_section section) noexcept {
+  return 1u << static_cast<unsigned>(section);
+}
+
+/// \param sections A bit for each section
+/// \returns The range of sections from the lowest bit to the highest
+std::pair<url_section, url_section> section_bounds(unsigned sections) noexcept {
+  auto first = url_section::scheme, last = url_section::fragment;
+  while (!(sections & section_bit(first))) {
+    first = static_cast<url_section>(static_cast<unsigned>(first) + 1);
+  }
+  while (!(sections & section_bit(last))) {
+    last = static_cast<url_section>(static_cast<unsigned>(last) - 1);
+  }
+  return {first, last};
+}
+
+/// Edits `url` and replaces the sections of `href` from `first` to
+/// `last`, which must include every section that the edit can change
+expected<void, std::error_code> edit_sections(
+    url_record &url,
+    url_record::string_type &href,
+    url_section first,
+    url_section last,
+    edit_function edit,
+    std::string_view value) {
+  auto range = details::find_sections(url, first, last);
+  auto result = edit(url, value);
+  if (result) {
+    details::replace_sections(url, range, href);
+  }
+  return result;
+}
+}  // namespace
+
+expected<void, std::error_code> url_editor::edit(component part, std::string_view value) {
+  if (error_) {
+    auto error = error_.value();
+    return make_unexpected(std::move(error));
+  }
+
+  auto edit = section_edit();
+  switch (part) {
+    case component::protocol:
+      edit = section_edit{edit_protocol, url_section::scheme, url_section::authority};
+      break;
+    case component::username:
+      edit = section_edit{edit_username, url_section::authority, url_section::authority};
+      break;
+    case component::password:
+      edit = section_edit{edit_password, url_section::authority, url_section::authority};
+      break;
+    case component::host:
+      edit = section_edit{edit_host, url_section::authority, url_section::authority};
+      break;
+    case component::hostname:
+      edit = section_edit{edit_hostname, url_section::authority, url_section::authority};
+      break;
+    case component::port:
+      edit = section_edit{edit_port, url_section::authority, url_section::authority};
+      break;
+    case component::pathname:
+      edit = pathname_edit(record_);
+      break;
+    case component::search:
+      edit = section_edit{edit_search, url_section::query, url_section::query};
+      break;
+    case component::hash:
+      edit = section_edit{edit_hash, url_section::fragment, url_section::fragment};
+      break;
+  }
+
+  auto result = edit.edit(record_, value);
+  if (!result) {
+    return edit_failed(result.error());
+  }
+  sections_ |= section_bit(edit.first) | section_bit(edit.last);
+  return {};
+}
+
+expected<void, std::error_code> url_editor::edit_failed(std::error_code error) {
+  if (!error_) {
+    error_ = error;
+  }
+  return make_unexpected(std::move(error));
+}
+
 url::url()
-  : url_()
-  , href_()
-  , view_(href_) {}
+  : url(allocator_type()) {}
+
+url::url(const allocator_type &alloc)
+  : url_(alloc)
+  , href_(alloc)
+  , view_(href_)
+  , parameters_(url_, this) {}
 
 url::url(url_record &&input) noexcept
-  : url_(input)
+  : url_(std::move(input))
   , href_(serialize(url_))
   , view_(href_)
-  , parameters_(url_) {}
+  , parameters_(url_, this) {}
+
+url::url(const url &other)
+  : url_(other.url_)
+  , href_(other.href_)
+  , view_(href_)
+  , parameters_(url_, this) {}
+
+url::url(url &&other) noexcept
+  : url_(std::move(other.url_))
+  , href_(std::move(other.href_))
+  , view_(href_)
+  , parameters_(std::move(other.parameters_)) {
+  parameters_.url_ = url_;
+  parameters_.owner_ = this;
+}
+
+url &url::operator = (const url &other) {
+  url_ = other.url_;
+  href_ = other.href_;
+  view_ = string_view(href_);
+  parameters_ = url_search_parameters(url_, this);
+  return *this;
+}
+
+url &url::operator = (url &&other) {
+  url_ = std::move(other.url_);
+  href_ = std::move(other.href_);
+  view_ = string_view(href_);
+  parameters_.parameters_ = std::move(other.parameters_.parameters_);
+  return *this;
+}
 
 void url::swap(url &other) noexcept {
   using std::swap;
   swap(url_, other.url_);
   swap(href_, other.href_);
+  swap(parameters_.parameters_, other.parameters_.parameters_);
   view_ = string_view(href_);
   other.view_ = string_view(other.href_);
 }
 
 void url::initialize(string_type &&input, optional<url_record> base) {
-  auto parsed_url = parse(input, base);
+  auto parsed_url = parse(input, base, get_allocator());
   if (!parsed_url) {
     throw url_parse_error(parsed_url.error());
   }
@@ -45,19 +320,53 @@ void url::initialize(string_type &&input, optional<url_record> base) {
 }
 
 
+expected<void, std::error_code> url::commit(url_editor &&editor) {
+  if (editor.error_) {
+    auto error = editor.error_.value();
+    return make_unexpected(std::move(error));
+  }
+
+  if (editor.sections_ == 0) {
+    return {};
+  }
+
+  // Only the sections between the first and last edited ones are
+  // serialized again
+  auto [first, last] = section_bounds(editor.sections_);
+  auto range = details::find_sections(url_, first, last);
+  url_.swap(editor.record_);
+  details::replace_sections(url_, range, href_);
+  view_ = string_view(href_);
+  if (editor.sections_ & section_bit(url_section::query)) {
+    parameters_ = url_search_parameters(url_, this);
+  }
+  return {};
+}
+
+void url::update_query(url_record::string_type &&query) {
+  auto range = details::find_sections(url_, url_section::query, url_section::query);
+  if (!query.empty()) {
+    url_.query = std::move(query);
+  } else {
+    url_.query = nullopt;
+  }
+  details::replace_sections(url_, range, href_);
+  view_ = string_view(href_);
+}
+
 void url::update_record(url_record &&record) {
-  url_ = record;
+  url_ = std::move(record);
   href_ = serialize(url_);
   view_ = string_view(href_);
-  parameters_ = url_search_parameters(url_);
+  parameters_ = url_search_parameters(url_, this);
 }
 
 url::string_type url::href() const {
-  return href_;
+  return string_type(href_);
 }
 
 expected<void, std::error_code> url::set_href(string_type &&href) {
-  auto new_url = details::basic_parse(std::move(href));
+  auto new_url = parse(href, nullopt, get_allocator());
   if (!new_url) {
     return make_unexpected(std::move(new_url.error()));
   }
@@ -67,208 +376,141 @@ expected<void, std::error_code> url::set_href(string_type &&href) {
 }
 
 url::string_type url::to_json() const {
-  return href_;
+  return string_type(href_);
 }
 
-url::string_type url::protocol() const { return url_.scheme + ":"; }
+url::string_type url::protocol() const {
+  return string_type(protocol_view());
+}
 
-expected<void, std::error_code> url::set_protocol(string_type &&protocol) {
-  auto new_url = details::basic_parse(
-      protocol + ":", nullopt, url_, url_parse_state::scheme_start);
-  if (!new_url) {
-    return make_unexpected(std::move(new_url.error()));
+url::string_view url::protocol_view() const noexcept {
+  if (view_.empty()) {
+    return ":";
   }
-
-  update_record(std::move(new_url.value()));
-  return {};
+  return view_.substr(0, url_.scheme.size() + 1);
 }
 
-url::string_type url::username() const { return url_.username; }
-
-expected<void, std::error_code> url::set_username(string_type &&username) {
-  if (url_.cannot_have_a_username_password_or_port()) {
-    return make_unexpected(make_error_code(
-        url_parse_errc::cannot_have_a_username_password_or_port));
-  }
+expected<void, std::error_code> url::set_protocol(string_type &&protocol) {
+  // Changing the scheme can remove a default port
+  auto result = edit_sections(
+      url_, href_, url_section::scheme, url_section::authority, edit_protocol, protocol);
+  view_ = string_view(href_);
+  return result;
+}
 
-  auto new_url = url_;
+url::string_type url::username() const { return string_type(url_.username); }
 
-  new_url.username.clear();
-  for (auto c : username) {
-    auto pct_encoded = percent_encode_byte(c, userinfo_set());
-    new_url.username += pct_encoded;
-  }
+url::string_view url::username_view() const noexcept { return url_.username; }
 
-  update_record(std::move(new_url));
-  return {};
+expected<void, std::error_code> url::set_username(string_type &&username) {
+  auto result = edit_sections(
+      url_, href_, url_section::authority, url_section::authority, edit_username, username);
+  view_ = string_view(href_);
+  return result;
 }
 
-url::string_type url::password() const { return url_.password; }
+url::string_type url::password() const { return string_type(url_.password); }
 
-expected<void, std::error_code> url::set_password(string_type &&password) {
-  if (url_.cannot_have_a_username_password_or_port()) {
-    return make_unexpected(make_error_code(
-        url_parse_errc::cannot_have_a_username_password_or_port));
-  }
-
-  auto new_url = url_;
+url::string_view url::password_view() const noexcept { return url_.password; }
 
-  new_url.password.clear();
-  for (auto c : password) {
-    auto pct_encoded = percent_encode_byte(c, userinfo_set());
-    new_url.password += pct_encoded;
-  }
-
-  update_record(std::move(new_url));
-  return {};
+expected<void, std::error_code> url::set_password(string_type &&password) {
+  auto result = edit_sections(
+      url_, href_, url_section::authority, url_section::authority, edit_password, password);
+  view_ = string_view(href_);
+  return result;
 }
 
 url::string_type url::host() const {
+  return string_type(host_view());
+}
+
+url::string_view url::host_view() const noexcept {
   if (!url_.host) {
     return {};
   }
 
-  if (!url_.port) {
-    return url_.host.value();
-  }
-
-  return url_.host.value() + ":" + std::to_string(url_.port.value());
+  // The host and port come last in the authority, and the
+  // credentials before them can't contain an unencoded '@'
+  auto authority = section_view(view_, url_, url_section::authority);
+  auto at = authority.find('@');
+  return authority.substr((at == string_view::npos)? 2 : at + 1);
 }
 
 expected<void, std::error_code> url::set_host(string_type &&host) {
-  if (url_.cannot_be_a_base_url) {
-    return make_unexpected(make_error_code(
-        url_parse_errc::cannot_be_a_base_url));
-  }
-
-  auto new_url = details::basic_parse(
-      std::move(host), nullopt, url_, url_parse_state::host);
-  if (!new_url) {
-    return make_unexpected(std::move(new_url.error()));
-  }
-
-  update_record(std::move(new_url.value()));
-  return {};
+  auto result = edit_sections(
+      url_, href_, url_section::authority, url_section::authority, edit_host, host);
+  view_ = string_view(href_);
+  return result;
 }
 
 url::string_type url::hostname() const {
+  return string_type(hostname_view());
+}
+
+url::string_view url::hostname_view() const noexcept {
   if (!url_.host) {
     return {};
   }
-
-  return url_.host.value();
+  return host_view().substr(0, url_.host.value().size());
 }
 
 expected<void, std::error_code> url::set_hostname(string_type &&hostname) {
-  if (url_.cannot_be_a_base_url) {
-    return make_unexpected(make_error_code(
-        url_parse_errc::cannot_be_a_base_url));
-  }
-
-  auto new_url = details::basic_parse(
-      std::move(hostname), nullopt, url_, url_parse_state::hostname);
-  if (!new_url) {
-    return make_unexpected(std::move(new_url.error()));
-  }
-
-  update_record(std::move(new_url.value()));
-  return {};
+  auto result = edit_sections(
+      url_, href_, url_section::authority, url_section::authority, edit_hostname, hostname);
+  view_ = string_view(href_);
+  return result;
 }
 
 url::string_type url::port() const {
+  return string_type(port_view());
+}
+
+url::string_view url::port_view() const noexcept {
   if (!url_.port) {
     return {};
   }
-
-  return std::to_string(url_.port.value());
+  return host_view().substr(url_.host.value().size() + 1);
 }
 
 expected<void, std::error_code> url::set_port(string_type &&port) {
-  if (url_.cannot_have_a_username_password_or_port()) {
-    return make_unexpected(make_error_code(
-        url_parse_errc::cannot_have_a_username_password_or_port));
-  }
-
-  if (port.empty()) {
-    auto new_url = url_;
-    new_url.port = nullopt;
-    update_record(std::move(new_url));
-  }
-  else {
-    auto new_url = details::basic_parse(
-        std::move(port), nullopt, url_, url_parse_state::port);
-    if (!new_url) {
-      return make_unexpected(std::move(new_url.error()));
-    }
-    update_record(std::move(new_url.value()));
-  }
-
-  return {};
+  auto result = edit_sections(
+      url_, href_, url_section::authority, url_section::authority, edit_port, port);
+  view_ = string_view(href_);
+  return result;
 }
 
 url::string_type url::pathname() const {
-  if (url_.cannot_be_a_base_url) {
-    return url_.path.front();
-  }
-
-  if (url_.path.empty()) {
-    return {};
-  }
+  return string_type(pathname_view());
+}
 
-  auto pathname = string_type("/");
-  for (const auto &segment : url_.path) {
-    pathname += segment;
-    pathname += "/";
-  }
-  return pathname.substr(0, pathname.length() - 1);
+url::string_view url::pathname_view() const noexcept {
+  return section_view(view_, url_, url_section::path);
 }
 
 expected<void, std::error_code> url::set_pathname(string_type &&pathname) {
-  if (url_.cannot_be_a_base_url) {
-    return make_unexpected(make_error_code(
-        url_parse_errc::cannot_be_a_base_url));
-  }
-
-  url_.path.clear();
-  auto new_url = details::basic_parse(
-      std::move(pathname), nullopt, url_, url_parse_state::path_start);
-  if (!new_url) {
-    return make_unexpected(std::move(new_url.error()));
-  }
-  update_record(std::move(new_url.value()));
-  return {};
+  auto edit = pathname_edit(url_);
+  auto result = edit_sections(url_, href_, edit.first, edit.last, edit.edit, pathname);
+  view_ = string_view(href_);
+  return result;
 }
 
 url::string_type url::search() const {
+  return string_type(search_view());
+}
+
+url::string_view url::search_view() const noexcept {
   if (!url_.query || url_.query.value().empty()) {
     return {};
   }
-
-  return "?" + url_.query.value();
+  return section_view(view_, url_, url_section::query);
 }
 
 expected<void, std::error_code> url::set_search(string_type &&search) {
-  auto url = url_;
-  if (search.empty()) {
-    url.query = nullopt;
-    update_record(std::move(url));
-    return {};
-  }
-
-  auto input = search;
-  if (input.front() == '?') {
-    auto first = std::begin(input), last = std::end(input);
-    input.assign(first + 1, last);
-  }
-
-  url_.query = "";
-  auto new_url = details::basic_parse(
-      std::move(input), nullopt, url_, url_parse_state::query);
-  if (!new_url) {
-    return make_unexpected(std::move(new_url.error()));
-  }
-  update_record(std::move(new_url.value()));
-  return {};
+  auto result = edit_sections(
+      url_, href_, url_section::query, url_section::query, edit_search, search);
+  view_ = string_view(href_);
+  parameters_ = url_search_parameters(url_, this);
+  return result;
 }
 
 url_search_parameters &url::search_parameters() {
@@ -276,50 +518,37 @@ url_search_parameters &url::search_parameters() {
 }
 
 url::string_type url::hash() const {
+  return string_type(hash_view());
+}
+
+url::string_view url::hash_view() const noexcept {
   if (!url_.fragment || url_.fragment.value().empty()) {
     return {};
   }
-
-  return "#" + url_.fragment.value();
+  return section_view(view_, url_, url_section::fragment);
 }
 
 expected<void, std::error_code> url::set_hash(string_type &&hash) {
-  if (hash.empty()) {
-    url_.fragment = nullopt;
-    update_record(std::move(url_));
-    return {};
-  }
-
-  auto input = hash;
-  if (input.front() == '#') {
-    auto first = std::begin(input), last = std::end(input);
-    input.assign(first + 1, last);
-  }
-
-  url_.fragment = "";
-  auto new_url = details::basic_parse(
-      std::move(input), nullopt, url_, url_parse_state::fragment);
-  if (!new_url) {
-    return make_unexpected(std::move(new_url.error()));
-  }
-  update_record(std::move(new_url.value()));
-  return {};
+  auto result = edit_sections(
+      url_, href_, url_section::fragment, url_section::fragment, edit_hash, hash);
+  view_ = string_view(href_);
+  return result;
 }
 
 url_record url::record() const {
-  return url_;
+  return url_record(url_, get_allocator());
 }
 
 bool url::is_special() const noexcept { return url_.is_special(); }
 
 bool url::validation_error() const noexcept { return url_.validation_error; }
 
-optional<std::uint16_t> url::default_port(const url::string_type &scheme) noexcept {
-  return details::default_port(string_view(scheme));
+optional<std::uint16_t> url::default_port(std::string_view scheme) noexcept {
+  return details::default_port(scheme);
 }
 
 void url::clear() {
-  update_record(url_record{});
+  update_record(url_record(get_allocator()));
 }
 
 const char *url::c_str() const noexcept {
@@ -327,7 +556,7 @@ const char *url::c_str() const noexcept {
 }
 
 url::operator url::string_type() const {
-  return href_;
+  return string_type(href_);
 }
 
 void swap(url &lhs, url &rhs) noexcept {
@@ -337,8 +566,9 @@ void swap(url &lhs, url &rhs) noexcept {
 namespace details {
 expected<url, std::error_code> make_url(
     url::string_type &&input,
-    optional<url_record> base) {
-  auto parsed_url = parse(std::move(input), std::move(base));
+    optional<url_record> base,
+    const url::allocator_type &alloc) {
+  auto parsed_url = parse(input, base, alloc);
   if (!parsed_url) {
     return make_unexpected(std::move(parsed_url.error()));
   }
@@ -0,0 +1,82 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "skyr/url_authority.hpp"
+#include "skyr/url_error.hpp"
+#include "url_host.hpp"
+#include "url_schemes.hpp"
+
+namespace skyr {
+namespace {
+/// \returns The port, `nullopt` if there are no digits, or an error
+///          if it isn't a number in range
+expected<optional<std::uint16_t>, url_parse_errc> parse_port(std::string_view input) noexcept {
+  if (input.empty()) {
+    return nullopt;
+  }
+
+  auto value = 0UL;
+  for (auto byte : input) {
+    if ((byte < '0') || (byte > '9')) {
+      return make_unexpected(url_parse_errc::invalid_port);
+    }
+    value = (value * 10) + (byte - '0');
+    // The same upper bound as the URL parser
+    if (value >= 65535) {
+      return make_unexpected(url_parse_errc::invalid_port);
+    }
+  }
+  return static_cast<std::uint16_t>(value);
+}
+
+expected<url_authority, std::error_code> parse_host_and_port(
+    std::string_view input, bool is_not_special, std::string_view scheme) {
+  // The host ends at the first ':' that isn't inside square brackets
+  auto separator = std::string_view::npos;
+  if (!input.empty() && (input.front() == '[')) {
+    auto close = input.find(']');
+    if ((close != std::string_view::npos) &&
+        (close + 1 < input.size()) && (input[close + 1] == ':')) {
+      separator = close + 1;
+    }
+  } else {
+    separator = input.find(':');
+  }
+
+  auto host_input = input.substr(0, separator);
+  if (host_input.empty()) {
+    return make_unexpected(make_error_code(url_parse_errc::empty_hostname));
+  }
+
+  auto host = details::parse_host(host_input, is_not_special);
+  if (!host) {
+    return make_unexpected(make_error_code(host.error()));
+  }
+
+  auto port = optional<std::uint16_t>();
+  if (separator != std::string_view::npos) {
+    auto parsed_port = parse_port(input.substr(separator + 1));
+    if (!parsed_port) {
+      return make_unexpected(make_error_code(parsed_port.error()));
+    }
+    port = parsed_port.value();
+    if (port && !scheme.empty() && details::is_default_port(scheme, port.value())) {
+      port = nullopt;
+    }
+  }
+
+  return url_authority{std::move(host.value()), port};
+}
+}  // namespace
+
+expected<url_authority, std::error_code> parse_authority(std::string_view input) {
+  return parse_host_and_port(input, false, std::string_view());
+}
+
+expected<url_authority, std::error_code> parse_authority(
+    std::string_view input, std::string_view scheme) {
+  return parse_host_and_port(input, !details::is_special(scheme), scheme);
+}
+}  // namespace skyr
@@ -0,0 +1,258 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include "skyr/url_batch.hpp"
+#include "skyr/url_parse.hpp"
+#include "url_fast_parse.hpp"
+
+namespace skyr {
+namespace {
+using components = details::url_components;
+
+std::size_t pathname_size(const url_record &record) {
+  if (record.cannot_be_a_base_url) {
+    return record.path.empty()? 0 : record.path.front().size();
+  }
+
+  return record.path.empty()? 0 : record.path.joined().size() + 1;
+}
+
+char *append(char *output, std::string_view value) {
+  if (value.empty()) {
+    return output;
+  }
+  std::memcpy(output, value.data(), value.size());
+  return output + value.size();
+}
+}  // namespace
+
+url_batch::string_type url_batch::entry::href() const {
+  auto output = string_type(scheme_);
+  output += ":";
+
+  if (has(components::has_host_flag)) {
+    output += "//";
+    if (!username_.empty() || !password_.empty()) {
+      output += username_;
+      if (!password_.empty()) {
+        output += ":";
+        output += password_;
+      }
+      output += "@";
+    }
+    output += host_;
+
+    if (has(components::has_port_flag)) {
+      output += ":";
+      output += std::to_string(port_);
+    }
+  }
+  else if (scheme_.compare("file") == 0) {
+    output += "//";
+  }
+
+  output += pathname_;
+
+  if (has(components::has_query_flag)) {
+    output += "?";
+    output += query_;
+  }
+
+  if (has(components::has_fragment_flag)) {
+    output += "#";
+    output += fragment_;
+  }
+
+  return output;
+}
+
+url_record url_batch::entry::to_record() const {
+  auto record = url_record{};
+  record.scheme = string_type(scheme_);
+  record.username = string_type(username_);
+  record.password = string_type(password_);
+  if (auto value = host()) {
+    record.host = string_type(value.value());
+  }
+  record.port = port();
+  for (auto it = path_begin(); it != path_end(); ++it) {
+    record.path.emplace_back(*it);
+  }
+  if (auto value = query()) {
+    record.query = string_type(value.value());
+  }
+  if (auto value = fragment()) {
+    record.fragment = string_type(value.value());
+  }
+  record.cannot_be_a_base_url = cannot_be_a_base_url();
+  record.validation_error = validation_error();
+  return record;
+}
+
+/// The memory owned by a batch, which is kept together so that it
+/// doesn't move when the batch does
+struct url_batch::arena {
+  explicit arena(size_type initial_size)
+    : components(initial_size)
+    , scratch(scratch_buffer, sizeof(scratch_buffer), &components)
+    , interned(&components) {}
+
+  /// Holds the components of every URL
+  std::pmr::monotonic_buffer_resource components;
+  char scratch_buffer[1024];
+  /// Holds the record parsed by the state machine, until its
+  /// components are copied
+  std::pmr::monotonic_buffer_resource scratch;
+  /// The schemes and hosts in the batch
+  std::pmr::unordered_set<string_view> interned;
+};
+
+url_batch::url_batch(optional<url_record> base, size_type initial_size)
+  : base_(std::move(base))
+  , arena_(std::make_unique<arena>(initial_size)) {}
+
+url_batch::url_batch(url_batch &&other) noexcept = default;
+
+url_batch &url_batch::operator = (url_batch &&other) noexcept = default;
+
+url_batch::~url_batch() = default;
+
+url_batch::string_view url_batch::copy(string_view value) {
+  if (value.empty()) {
+    return {};
+  }
+
+  auto data = static_cast<char *>(arena_->components.allocate(value.size(), 1));
+  std::memcpy(data, value.data(), value.size());
+  return string_view(data, value.size());
+}
+
+url_batch::string_view url_batch::intern(string_view value) {
+  auto it = arena_->interned.find(value);
+  if (it != arena_->interned.end()) {
+    return *it;
+  }
+  auto result = copy(value);
+  arena_->interned.insert(result);
+  return result;
+}
+
+url_batch::const_reference url_batch::push_back(string_view input) {
+  auto result = entry{};
+
+  auto fast_url = details::fast_parse(input);
+  if (fast_url) {
+    const auto &parts = fast_url.value();
+    result.scheme_ = intern(parts.scheme);
+    result.host_ = intern(parts.host);
+    result.flags_ |= components::has_host_flag;
+    if (parts.port) {
+      result.port_ = parts.port.value();
+      result.flags_ |= components::has_port_flag;
+    }
+
+    // The path, query and fragment are contiguous in the input, so
+    // they are copied in one piece and sliced
+    auto first = parts.path.empty()? input.size() : parts.path.data() - input.data();
+    if (parts.query) {
+      first = std::min<std::size_t>(first, parts.query.value().data() - input.data() - 1);
+    }
+    if (parts.fragment) {
+      first = std::min<std::size_t>(first, parts.fragment.value().data() - input.data() - 1);
+    }
+    auto tail = copy(input.substr(first));
+    auto slice = [&] (string_view component) {
+      return tail.substr(component.data() - input.data() - first, component.size());
+    };
+
+    result.pathname_ = parts.path.empty()? string_view("/") : slice(parts.path);
+    if (parts.query) {
+      result.query_ = slice(parts.query.value());
+      result.flags_ |= components::has_query_flag;
+    }
+    if (parts.fragment) {
+      result.fragment_ = slice(parts.fragment.value());
+      result.flags_ |= components::has_fragment_flag;
+    }
+
+    results_.emplace_back(result);
+    return results_.back();
+  }
+
+  {
+    auto url = parse(input, base_, url_record::allocator_type(&arena_->scratch));
+    if (!url) {
+      results_.emplace_back(make_unexpected(std::move(url.error())));
+    }
+    else {
+      push_back_record(url.value(), result);
+    }
+  }
+  arena_->scratch.release();
+  return results_.back();
+}
+
+void url_batch::push_back_record(const url_record &record, entry &result) {
+  result.scheme_ = intern(record.scheme);
+  if (record.host) {
+    result.host_ = intern(record.host.value());
+    result.flags_ |= components::has_host_flag;
+  }
+  if (record.port) {
+    result.port_ = record.port.value();
+    result.flags_ |= components::has_port_flag;
+  }
+  if (record.cannot_be_a_base_url) {
+    result.flags_ |= components::cannot_be_a_base_url_flag;
+  }
+  if (record.validation_error) {
+    result.flags_ |= components::validation_error_flag;
+  }
+
+  // Everything apart from the scheme and host is written to a single
+  // allocation
+  auto size =
+      record.username.size() + record.password.size() + pathname_size(record) +
+      (record.query ? record.query.value().size() : 0) +
+      (record.fragment ? record.fragment.value().size() : 0);
+  auto data = (size != 0)? static_cast<char *>(arena_->components.allocate(size, 1)) : nullptr;
+  auto output = data;
+
+  auto write = [&output] (string_view value) {
+    auto first = output;
+    output = append(output, value);
+    return string_view(first, value.size());
+  };
+
+  result.username_ = write(record.username);
+  result.password_ = write(record.password);
+
+  auto path_first = output;
+  if (record.cannot_be_a_base_url) {
+    if (!record.path.empty()) {
+      output = append(output, record.path.front());
+    }
+  }
+  else if (!record.path.empty()) {
+    output = append(output, "/");
+    output = append(output, record.path.joined());
+  }
+  result.pathname_ = string_view(path_first, output - path_first);
+
+  if (record.query) {
+    result.query_ = write(record.query.value());
+    result.flags_ |= components::has_query_flag;
+  }
+  if (record.fragment) {
+    result.fragment_ = write(record.fragment.value());
+    result.flags_ |= components::has_fragment_flag;
+  }
+
+  results_.emplace_back(result);
+}
+}  // namespace skyr
@@ -0,0 +1,307 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <limits>
+#include <stdexcept>
+#include "url_components_builder.hpp"
+
+namespace skyr {
+namespace details {
+namespace {
+/// \tparam String The type of the output buffer
+template <class String>
+class url_components_builder {
+ public:
+  url_components_builder(
+      String &href, url_components &components, std::size_t capacity)
+    : href_(href)
+    , components_(components) {
+    href_.clear();
+    href_.reserve(capacity);
+    components_ = url_components{};
+  }
+
+  void append(std::string_view value) {
+    href_.append(value.data(), value.size());
+  }
+
+  void append(std::size_t index, std::string_view value) {
+    begin(index);
+    append(value);
+    components_.ranges[index].length = offset() - components_.ranges[index].offset;
+  }
+
+  void begin(std::size_t index) {
+    components_.ranges[index].offset = offset();
+  }
+
+  void set_flag(std::uint8_t flag, bool value = true) {
+    if (value) {
+      components_.flags |= flag;
+    }
+  }
+
+  /// Serializes the components in the same order as `serialize`
+  template <class AppendPath>
+  void build(
+      std::string_view scheme,
+      std::string_view username,
+      std::string_view password,
+      const optional<std::string_view> &host,
+      const optional<std::uint16_t> &port,
+      bool cannot_be_a_base_url,
+      AppendPath append_path,
+      const optional<std::string_view> &query,
+      const optional<std::string_view> &fragment) {
+    append(url_components::scheme_index, scheme);
+    append(":");
+
+    if (host) {
+      append("//");
+      begin(url_components::username_index);
+      begin(url_components::password_index);
+      if (!username.empty() || !password.empty()) {
+        append(url_components::username_index, username);
+        begin(url_components::password_index);
+        if (!password.empty()) {
+          append(":");
+          append(url_components::password_index, password);
+        }
+        append("@");
+      }
+      append(url_components::host_index, host.value());
+      set_flag(url_components::has_host_flag);
+
+      if (port) {
+        append(":");
+        append(std::to_string(port.value()));
+        components_.port = port.value();
+        set_flag(url_components::has_port_flag);
+      }
+    }
+    else {
+      if (scheme.compare("file") == 0) {
+        append("//");
+      }
+      begin(url_components::username_index);
+      begin(url_components::password_index);
+      begin(url_components::host_index);
+    }
+
+    begin(url_components::path_index);
+    append_path(*this);
+    components_.ranges[url_components::path_index].length =
+        offset() - components_.ranges[url_components::path_index].offset;
+    set_flag(url_components::cannot_be_a_base_url_flag, cannot_be_a_base_url);
+
+    if (query) {
+      append("?");
+      append(url_components::query_index, query.value());
+      set_flag(url_components::has_query_flag);
+    }
+    else {
+      begin(url_components::query_index);
+    }
+
+    if (fragment) {
+      append("#");
+      append(url_components::fragment_index, fragment.value());
+      set_flag(url_components::has_fragment_flag);
+    }
+    else {
+      begin(url_components::fragment_index);
+    }
+  }
+
+ private:
+  std::uint32_t offset() const {
+    if (href_.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::length_error("URL is too long for 32-bit component offsets");
+    }
+    return static_cast<std::uint32_t>(href_.size());
+  }
+
+  String &href_;
+  url_components &components_;
+};
+
+inline optional<std::string_view> to_view(const optional<url_record::string_type> &value) {
+  if (!value) {
+    return nullopt;
+  }
+  return std::string_view(value.value());
+}
+
+inline std::size_t digit_count(std::uint16_t value) noexcept {
+  auto count = std::size_t{1};
+  while (value >= 10) {
+    value /= 10;
+    ++count;
+  }
+  return count;
+}
+
+template <class String>
+void build_record_components(
+    const url_record &record,
+    String &href,
+    url_components &components) {
+  auto capacity =
+      record.scheme.size() + record.username.size() + record.password.size() +
+      (record.host ? record.host.value().size() : 0) +
+      (record.query ? record.query.value().size() : 0) +
+      (record.fragment ? record.fragment.value().size() : 0) + 16;
+  capacity += record.path.joined().size() + 1;
+
+  auto builder = url_components_builder<String>(href, components, capacity);
+  builder.set_flag(url_components::validation_error_flag, record.validation_error);
+  builder.build(
+      record.scheme,
+      record.username,
+      record.password,
+      to_view(record.host),
+      record.port,
+      record.cannot_be_a_base_url,
+      [&record] (url_components_builder<String> &builder) {
+        if (record.cannot_be_a_base_url) {
+          if (!record.path.empty()) {
+            builder.append(record.path.front());
+          }
+          return;
+        }
+
+        if (!record.path.empty()) {
+          builder.append("/");
+          builder.append(record.path.joined());
+        }
+      },
+      to_view(record.query),
+      to_view(record.fragment));
+}
+}  // namespace
+
+void build_url_components(
+    const url_record &record,
+    std::string &href,
+    url_components &components) {
+  build_record_components(record, href, components);
+}
+
+void build_url_components(
+    const url_record &record,
+    url_record::string_type &href,
+    url_components &components) {
+  build_record_components(record, href, components);
+}
+
+void build_url_components(
+    const fast_url_parts &parts,
+    std::string &href,
+    url_components &components) {
+  auto builder = url_components_builder<std::string>(href, components, serialized_size(parts));
+  builder.build(
+      parts.scheme,
+      {},
+      {},
+      parts.host,
+      parts.port,
+      false,
+      [&parts] (url_components_builder<std::string> &builder) {
+        builder.append(parts.path.empty()? "/" : parts.path);
+      },
+      parts.query,
+      parts.fragment);
+}
+
+std::size_t serialized_size(const fast_url_parts &parts) noexcept {
+  auto size = parts.scheme.size() + 3 + parts.host.size();
+  if (parts.port) {
+    size += 1 + digit_count(parts.port.value());
+  }
+  size += parts.path.empty()? 1 : parts.path.size();
+  if (parts.query) {
+    size += 1 + parts.query.value().size();
+  }
+  if (parts.fragment) {
+    size += 1 + parts.fragment.value().size();
+  }
+  return size;
+}
+
+void borrow_url_components(
+    std::string_view input,
+    const fast_url_parts &parts,
+    url_components &components) noexcept {
+  auto range = [input] (std::string_view component) {
+    return url_components::range{
+      static_cast<std::uint32_t>(component.data() - input.data()),
+      static_cast<std::uint32_t>(component.size())};
+  };
+
+  components = url_components{};
+  components.ranges[url_components::scheme_index] = range(parts.scheme);
+  components.ranges[url_components::host_index] = range(parts.host);
+  components.ranges[url_components::username_index].offset =
+      components.ranges[url_components::host_index].offset;
+  components.ranges[url_components::password_index].offset =
+      components.ranges[url_components::host_index].offset;
+  components.flags |= url_components::has_host_flag;
+
+  if (parts.port) {
+    components.port = parts.port.value();
+    components.flags |= url_components::has_port_flag;
+  }
+
+  components.ranges[url_components::path_index] = range(parts.path);
+
+  const auto &path = components.ranges[url_components::path_index];
+  components.ranges[url_components::query_index].offset = path.offset + path.length;
+  if (parts.query) {
+    components.ranges[url_components::query_index] = range(parts.query.value());
+    components.flags |= url_components::has_query_flag;
+  }
+
+  components.ranges[url_components::fragment_index].offset =
+      static_cast<std::uint32_t>(input.size());
+  if (parts.fragment) {
+    components.ranges[url_components::fragment_index] = range(parts.fragment.value());
+    components.flags |= url_components::has_fragment_flag;
+  }
+}
+
+url_record make_url_record(std::string_view href, const url_components &components) {
+  auto to_string = [] (std::string_view value) {
+    return url_record::string_type(value.data(), value.size());
+  };
+
+  auto record = url_record{};
+  record.scheme = to_string(components.view(href, url_components::scheme_index));
+  record.username = to_string(components.view(href, url_components::username_index));
+  record.password = to_string(components.view(href, url_components::password_index));
+  if (components.has(url_components::has_host_flag)) {
+    record.host = to_string(components.view(href, url_components::host_index));
+  }
+  if (components.has(url_components::has_port_flag)) {
+    record.port = components.port;
+  }
+
+  record.cannot_be_a_base_url = components.has(url_components::cannot_be_a_base_url_flag);
+  auto first = url_path_iterator(
+      components.view(href, url_components::path_index), record.cannot_be_a_base_url);
+  for (auto it = first; it != url_path_iterator(); ++it) {
+    record.path.push_back(*it);
+  }
+
+  if (components.has(url_components::has_query_flag)) {
+    record.query = to_string(components.view(href, url_components::query_index));
+  }
+  if (components.has(url_components::has_fragment_flag)) {
+    record.fragment = to_string(components.view(href, url_components::fragment_index));
+  }
+  record.validation_error = components.has(url_components::validation_error_flag);
+  return record;
+}
+}  // namespace details
+}  // namespace skyr
@@ -0,0 +1,75 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_COMPONENTS_BUILDER_HPP
+#define SKYR_URL_COMPONENTS_BUILDER_HPP
+
+#include <string>
+#include <string_view>
+#include <skyr/url_record.hpp>
+#include <skyr/details/url_components.hpp>
+#include "url_fast_parse.hpp"
+
+namespace skyr {
+/// \exclude
+namespace details {
+/// Serializes a `url_record` into `href`, in the same way as
+/// `serialize`, and records the position of each component
+///
+/// \param record A URL record
+/// \param href The output buffer, which is overwritten
+/// \param components The component positions
+void build_url_components(
+    const url_record &record,
+    std::string &href,
+    url_components &components);
+
+/// Serializes a `url_record` into `href`, which allocates from its
+/// own memory resource, and records the position of each component
+///
+/// \param record A URL record
+/// \param href The output buffer, which is overwritten
+/// \param components The component positions
+void build_url_components(
+    const url_record &record,
+    url_record::string_type &href,
+    url_components &components);
+
+/// Serializes the components recognised by `fast_parse` into `href`
+/// and records the position of each component
+///
+/// \param parts The components recognised by `fast_parse`
+/// \param href The output buffer, which is overwritten
+/// \param components The component positions
+void build_url_components(
+    const fast_url_parts &parts,
+    std::string &href,
+    url_components &components);
+
+/// \param parts The components recognised by `fast_parse`
+/// \returns The length of the serialized URL
+std::size_t serialized_size(const fast_url_parts &parts) noexcept;
+
+/// Records the position of each component recognised by `fast_parse`
+/// relative to `input`, without copying
+///
+/// The input must already be in its serialized form, which is the
+/// case when `serialized_size(parts) == input.size()`.
+///
+/// \param input The input string passed to `fast_parse`
+/// \param parts The components recognised by `fast_parse`
+/// \param components The component positions
+void borrow_url_components(
+    std::string_view input,
+    const fast_url_parts &parts,
+    url_components &components) noexcept;
+/// \param href The serialized URL
+/// \param components The component positions in `href`
+/// \returns A `url_record` with the same components
+url_record make_url_record(std::string_view href, const url_components &components);
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_COMPONENTS_BUILDER_HPP
@@ -42,6 +42,12 @@ std::string url_parse_error_category::message(int error) const noexcept {
       return "Cannot have a username, password or port";
     case url_parse_errc::invalid_port:
       return "Invalid port";
+    case url_parse_errc::input_too_long:
+      return "Input is too long";
+    case url_parse_errc::invalid_request_target:
+      return "Invalid request target";
+    case url_parse_errc::not_a_static_url:
+      return "Not a URL that can be parsed at compile time";
     default:
       return "(Unknown error)";
   }
@@ -53,4 +59,55 @@ static const url_parse_error_category category{};
 std::error_code make_error_code(url_parse_errc error) {
   return std::error_code(static_cast<int>(error), category);
 }
+
+namespace {
+class url_validation_error_category : public std::error_category {
+ public:
+  const char *name() const noexcept override;
+  std::string message(int error) const noexcept override;
+};
+
+const char *url_validation_error_category::name() const noexcept {
+  return "validation";
+}
+
+std::string url_validation_error_category::message(int error) const noexcept {
+  switch (static_cast<url_validation_errc>(error)) {
+    case url_validation_errc::leading_or_trailing_c0_control_or_space:
+      return "Leading or trailing C0 control or space";
+    case url_validation_errc::tab_or_newline:
+      return "Tab or newline";
+    case url_validation_errc::invalid_url_unit:
+      return "Invalid URL unit";
+    case url_validation_errc::special_scheme_missing_following_solidus:
+      return "Special scheme missing following solidus";
+    case url_validation_errc::missing_scheme_non_relative_url:
+      return "Missing scheme in non-relative URL";
+    case url_validation_errc::invalid_reverse_solidus:
+      return "Invalid reverse solidus";
+    case url_validation_errc::invalid_credentials:
+      return "Invalid credentials";
+    case url_validation_errc::host_missing:
+      return "Host missing";
+    case url_validation_errc::port_out_of_range:
+      return "Port out of range";
+    case url_validation_errc::port_invalid:
+      return "Invalid port";
+    case url_validation_errc::file_invalid_windows_drive_letter:
+      return "Invalid Windows drive letter in file URL";
+    case url_validation_errc::file_invalid_windows_drive_letter_host:
+      return "Invalid Windows drive letter host in file URL";
+    case url_validation_errc::file_empty_path_segment:
+      return "Empty path segment in file URL";
+    default:
+      return "(Unknown error)";
+  }
+}
+
+static const url_validation_error_category validation_category{};
+}  // namespace
+
+std::error_code make_error_code(url_validation_errc error) {
+  return std::error_code(static_cast<int>(error), validation_category);
+}
 }  // namespace skyr
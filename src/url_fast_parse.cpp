@@ -0,0 +1,99 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include "url_fast_parse.hpp"
+#include "skyr/details/url_fast_scan.hpp"
+
+namespace skyr {
+namespace details {
+namespace {
+optional<fast_url_parts> to_fast_url_parts(const fast_url_scan &scan) noexcept {
+  auto parts = fast_url_parts{};
+  parts.scheme = scan.scheme;
+  parts.host = scan.host;
+  parts.port_string = scan.port_string;
+  if (scan.has_port) {
+    parts.port = scan.port;
+  }
+  parts.path = scan.path;
+  if (scan.has_query) {
+    parts.query = scan.query;
+  }
+  if (scan.has_fragment) {
+    parts.fragment = scan.fragment;
+  }
+  return parts;
+}
+}  // namespace
+
+optional<fast_url_parts> fast_parse(std::string_view input) noexcept {
+  auto scan = fast_url_scan{};
+  if (!scan_fast_url(input, scan)) {
+    return nullopt;
+  }
+  return to_fast_url_parts(scan);
+}
+
+optional<fast_url_parts> fast_parse_origin(std::string_view input) noexcept {
+  auto scan = fast_url_scan{};
+  if (!scan_fast_origin(input, scan)) {
+    return nullopt;
+  }
+  return to_fast_url_parts(scan);
+}
+
+optional<fast_url_parts> fast_parse_request_target(
+    std::string_view scheme, std::string_view host, std::string_view target) noexcept {
+  if (!is_fast_scheme(scheme) || target.empty() || (target.front() != '/')) {
+    return nullopt;
+  }
+
+  auto scan = fast_url_scan{};
+  scan.scheme = scheme;
+  if (!scan_host_and_port(host, scan) || !host.empty() ||
+      !scan_path_query_and_fragment(target, scan)) {
+    return nullopt;
+  }
+  return to_fast_url_parts(scan);
+}
+
+url_record make_url_record(
+    const fast_url_parts &parts,
+    const url_record::allocator_type &alloc) {
+  auto url = url_record(alloc);
+  url.scheme.assign(parts.scheme.data(), parts.scheme.size());
+  url.host = url.make_string(parts.host);
+  url.port = parts.port;
+
+  if (parts.path.empty()) {
+    url.path.emplace_back();
+  }
+  else {
+    auto path = parts.path.substr(1);
+    url.path.reserve(
+        path.size(), static_cast<std::size_t>(std::count(begin(path), end(path), '/')) + 1);
+    while (true) {
+      auto separator = path.find('/');
+      url.path.emplace_back(path.substr(0, separator));
+      if (separator == std::string_view::npos) {
+        break;
+      }
+      path.remove_prefix(separator + 1);
+    }
+  }
+
+  if (parts.query) {
+    url.query = url.make_string(parts.query.value());
+  }
+
+  if (parts.fragment) {
+    url.fragment = url.make_string(parts.fragment.value());
+  }
+
+  return url;
+}
+}  // namespace details
+}  // namespace skyr
@@ -0,0 +1,79 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_FAST_PARSE_HPP
+#define SKYR_URL_FAST_PARSE_HPP
+
+#include <string_view>
+#include <cstdint>
+#include <skyr/optional.hpp>
+#include <skyr/url_record.hpp>
+
+namespace skyr {
+/// \exclude
+namespace details {
+/// The components of a URL recognised by `fast_parse`, as views
+/// into the input string
+struct fast_url_parts {
+  /// The scheme, without the trailing `":"`
+  std::string_view scheme;
+  /// The host, which is already in its serialized form
+  std::string_view host;
+  /// The port digits as they appear in the input, if any
+  std::string_view port_string;
+  /// The port, or `nullopt` if it is absent or the default port
+  optional<std::uint16_t> port;
+  /// The path, including the leading `"/"`, or an empty view
+  std::string_view path;
+  /// The query, without the leading `"?"`
+  optional<std::string_view> query;
+  /// The fragment, without the leading `"#"`
+  optional<std::string_view> fragment;
+};
+
+/// Recognises the common shape of an `http`, `https`, `ws` or `wss`
+/// URL in a single linear scan: printable ASCII only, a lowercase
+/// domain host, no credentials, no dot segments and nothing that
+/// needs percent encoding.
+///
+/// The components of any URL this function accepts are exactly those
+/// that the full WhatWG state machine would produce, and parsing it
+/// raises no validation errors.
+///
+/// \param input The input string
+/// \returns The URL components, or `nullopt` if the input needs the
+///          full parser
+optional<fast_url_parts> fast_parse(std::string_view input) noexcept;
+
+/// Recognises the scheme, host and port at the start of an input in
+/// the shape accepted by `fast_parse`, without looking at the path,
+/// query or fragment
+///
+/// \param input The input string
+/// \returns The scheme, host and port, or `nullopt` if the input
+///          needs the full parser
+optional<fast_url_parts> fast_parse_origin(std::string_view input) noexcept;
+
+/// Recognises an origin-form HTTP request target and a Host header
+/// that together have the shape accepted by `fast_parse`
+///
+/// \param scheme The scheme
+/// \param host The Host header
+/// \param target The request target
+/// \returns The URL components, or `nullopt` if the request target
+///          needs the full parser
+optional<fast_url_parts> fast_parse_request_target(
+    std::string_view scheme, std::string_view host, std::string_view target) noexcept;
+
+/// \param parts The components recognised by `fast_parse`
+/// \param alloc The allocator used by the returned record
+/// \returns A `url_record` built from the components
+url_record make_url_record(
+    const fast_url_parts &parts,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_FAST_PARSE_HPP
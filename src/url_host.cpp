@@ -0,0 +1,116 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include "url_host.hpp"
+#include "skyr/domain.hpp"
+#include "skyr/percent_encode.hpp"
+#include "skyr/details/char_class.hpp"
+
+namespace skyr {
+namespace details {
+namespace {
+inline bool is_forbidden_host_point(std::string_view::value_type byte) noexcept {
+  return is_in_class(byte, char_class::forbidden_host);
+}
+
+expected<url_host, url_parse_errc> parse_opaque_host(std::string_view input) {
+  auto first = begin(input), last = end(input);
+  auto it = std::find_if(
+      first, last, [] (auto byte) -> bool {
+        return (byte != '%') && is_forbidden_host_point(byte);
+      });
+  if (it != last) {
+      // result.validation_error = true;
+      return make_unexpected(url_parse_errc::forbidden_host_point);
+    }
+
+  auto output = std::string();
+  for (auto c : input) {
+    output += percent_encode_byte(c);
+  }
+  return url_host{url_host_type::opaque, std::move(output), nullopt, nullopt};
+}
+}  // namespace
+
+bool is_plain_ascii_domain(std::string_view input) noexcept {
+  // At least one label must start with a letter, because a label
+  // that starts with a letter is never a number
+  auto has_alpha_label = false;
+  auto label_start = true;
+  for (auto byte : input) {
+    if (!is_in_class(byte, char_class::fast_host)) {
+      return false;
+    }
+    has_alpha_label |= label_start && (byte >= 'a') && (byte <= 'z');
+    label_start = (byte == '.');
+  }
+  return has_alpha_label;
+}
+
+expected<url_host, url_parse_errc> parse_host(
+    std::string_view input, bool is_not_special) {
+  if (!input.empty() && (input.front() == '[')) {
+    if (input.back() != ']') {
+      // result.validation_error = true;
+      return make_unexpected(url_parse_errc::invalid_ipv6_address);
+    }
+
+    auto view = std::string_view(input);
+    view.remove_prefix(1);
+    view.remove_suffix(1);
+    auto ipv6_address = parse_ipv6_address(view);
+    if (ipv6_address) {
+      return url_host{
+          url_host_type::ipv6_address,
+          "[" + ipv6_address.value().to_string() + "]",
+          nullopt,
+          ipv6_address.value()};
+    }
+    else {
+      return make_unexpected(url_parse_errc::invalid_ipv6_address);
+    }
+  }
+
+  if (is_not_special) {
+    return parse_opaque_host(input);
+  }
+
+  if (is_plain_ascii_domain(input)) {
+    return url_host{url_host_type::domain, std::string(input), nullopt, nullopt};
+  }
+
+  auto domain = percent_decode(input);
+  if (!domain) {
+    return make_unexpected(url_parse_errc::cannot_decode_host_point);
+  }
+
+  auto ascii_domain = domain_to_ascii(domain.value());
+  if (!ascii_domain) {
+    return make_unexpected(url_parse_errc::domain_error);
+  }
+
+  auto it = std::find_if(
+      begin(ascii_domain.value()), end(ascii_domain.value()), is_forbidden_host_point);
+  if (it != end(ascii_domain.value())) {
+    // result.validation_error = true;
+    return make_unexpected(url_parse_errc::domain_error);
+  }
+
+  auto host = parse_ipv4_address(ascii_domain.value());
+  if (!host) {
+    if (host.error() == make_error_code(ipv4_address_errc::overflow)) {
+      return make_unexpected(url_parse_errc::invalid_ipv4_address);
+    }
+    else {
+      return url_host{
+          url_host_type::domain, std::move(ascii_domain.value()), nullopt, nullopt};
+    }
+  }
+  return url_host{
+      url_host_type::ipv4_address, host.value().to_string(), host.value(), nullopt};
+}
+}  // namespace details
+}  // namespace skyr
@@ -0,0 +1,35 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_HOST_HPP
+#define SKYR_URL_HOST_HPP
+
+#include <string_view>
+#include <skyr/expected.hpp>
+#include <skyr/url_error.hpp>
+#include <skyr/url_authority.hpp>
+
+namespace skyr {
+/// \exclude
+namespace details {
+/// \param input A host
+/// \returns `true` if `input` is already an ASCII domain that can't
+///          be mistaken for an IPv4 address, so that parsing it as
+///          the host of a special URL leaves it unchanged
+bool is_plain_ascii_domain(std::string_view input) noexcept;
+
+/// Parses a host, as described in the
+/// [WhatWG URL specification](https://url.spec.whatwg.org/#host-parsing)
+///
+/// \param input The host, without a port
+/// \param is_not_special `true` if the host is parsed as an opaque
+///        host
+/// \returns The host, or an error
+expected<url_host, url_parse_errc> parse_host(
+    std::string_view input, bool is_not_special = false);
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_HOST_HPP
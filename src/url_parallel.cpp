@@ -0,0 +1,221 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include "skyr/url_parallel.hpp"
+
+namespace skyr {
+namespace {
+/// A range of chunk indices owned by one thread
+///
+/// The range is packed into one word so that the owner can take
+/// chunks from the front, and other threads can steal from the back,
+/// with a single compare-and-swap. Each chunk index is handed out
+/// exactly once, so a range can never reappear with the same value.
+class chunk_range {
+ public:
+  void assign(std::uint32_t first, std::uint32_t last) noexcept {
+    range_.store(pack(first, last), std::memory_order_release);
+  }
+
+  /// Takes the first chunk in the range
+  bool pop_front(std::uint32_t &chunk) noexcept {
+    auto range = range_.load(std::memory_order_acquire);
+    while (true) {
+      auto first = front(range), last = back(range);
+      if (first >= last) {
+        return false;
+      }
+
+      if (range_.compare_exchange_weak(
+          range, pack(first + 1, last), std::memory_order_acq_rel)) {
+        chunk = first;
+        return true;
+      }
+    }
+  }
+
+  /// Takes the back half of the range
+  bool steal(std::uint32_t &first, std::uint32_t &last) noexcept {
+    auto range = range_.load(std::memory_order_acquire);
+    while (true) {
+      auto range_first = front(range), range_last = back(range);
+      if (range_first >= range_last) {
+        return false;
+      }
+
+      auto middle = range_last - (range_last - range_first + 1) / 2;
+      if (range_.compare_exchange_weak(
+          range, pack(range_first, middle), std::memory_order_acq_rel)) {
+        first = middle;
+        last = range_last;
+        return true;
+      }
+    }
+  }
+
+ private:
+  static std::uint64_t pack(std::uint32_t first, std::uint32_t last) noexcept {
+    return (static_cast<std::uint64_t>(first) << 32) | last;
+  }
+
+  static std::uint32_t front(std::uint64_t range) noexcept {
+    return static_cast<std::uint32_t>(range >> 32);
+  }
+
+  static std::uint32_t back(std::uint64_t range) noexcept {
+    return static_cast<std::uint32_t>(range);
+  }
+
+  std::atomic<std::uint64_t> range_{0};
+};
+
+/// Keeps each thread's range on its own cache line
+struct alignas(64) worker_state {
+  chunk_range chunks;
+};
+
+std::size_t thread_count(
+    const parallel_parse_options &options, std::size_t chunk_count) {
+  auto count = options.thread_count;
+  if (count == 0) {
+    count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  return std::max<std::size_t>(std::min(count, chunk_count), 1);
+}
+}  // namespace
+
+parallel_url_batch parse_parallel(
+    const std::vector<std::string_view> &inputs,
+    const optional<url_record> &base,
+    const parallel_parse_options &options) {
+  auto result = parallel_url_batch{};
+  result.chunk_size_ = std::max<std::size_t>(options.chunk_size, 1);
+  result.size_ = inputs.size();
+
+  auto chunk_count = (inputs.size() + result.chunk_size_ - 1) / result.chunk_size_;
+  if (chunk_count > std::numeric_limits<std::uint32_t>::max()) {
+    result.chunk_size_ = (inputs.size() / std::numeric_limits<std::uint32_t>::max()) + 1;
+    chunk_count = (inputs.size() + result.chunk_size_ - 1) / result.chunk_size_;
+  }
+  result.chunks_.resize(chunk_count);
+
+  auto workers = thread_count(options, chunk_count);
+  auto input_size = std::size_t{0};
+  for (const auto &input : inputs) {
+    input_size += input.size();
+  }
+
+  // Each thread gets its own batch, and so its own arena and host
+  // cache
+  for (auto i = 0UL; i < workers; ++i) {
+    result.batches_.emplace_back(base, std::max<std::size_t>(input_size / workers, 4096));
+    result.batches_.back().reserve(inputs.size() / workers + result.chunk_size_);
+  }
+
+  auto states = std::unique_ptr<worker_state[]>(new worker_state[workers]);
+  for (auto i = 0UL; i < workers; ++i) {
+    states[i].chunks.assign(
+        static_cast<std::uint32_t>(chunk_count * i / workers),
+        static_cast<std::uint32_t>(chunk_count * (i + 1) / workers));
+  }
+
+  auto parse_chunk = [&] (std::size_t worker, std::uint32_t chunk) {
+    auto &batch = result.batches_[worker];
+    result.chunks_[chunk] = {worker, batch.size()};
+    auto first = chunk * result.chunk_size_;
+    auto last = std::min(first + result.chunk_size_, inputs.size());
+    for (auto i = first; i < last; ++i) {
+      batch.push_back(inputs[i]);
+    }
+  };
+
+  auto run = [&] (std::size_t worker) {
+    auto chunk = std::uint32_t{0};
+    while (true) {
+      while (states[worker].chunks.pop_front(chunk)) {
+        parse_chunk(worker, chunk);
+      }
+
+      auto stolen = false;
+      for (auto i = 1UL; i < workers; ++i) {
+        auto first = std::uint32_t{0}, last = std::uint32_t{0};
+        if (states[(worker + i) % workers].chunks.steal(first, last)) {
+          states[worker].chunks.assign(first, last);
+          stolen = true;
+          break;
+        }
+      }
+
+      if (!stolen) {
+        return;
+      }
+    }
+  };
+
+  auto errors = std::vector<std::exception_ptr>(workers);
+  auto threads = std::vector<std::thread>{};
+  threads.reserve(workers - 1);
+  for (auto i = 1UL; i < workers; ++i) {
+    try {
+      threads.emplace_back([&run, &errors, i] {
+        try {
+          run(i);
+        }
+        catch (...) {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+    catch (const std::system_error &) {
+      // The chunks of workers that didn't start are stolen by the
+      // ones that did, including this thread
+      break;
+    }
+  }
+
+  try {
+    run(0);
+  }
+  catch (...) {
+    errors[0] = std::current_exception();
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  return result;
+}
+
+parallel_url_batch parse_parallel_lines(
+    std::string_view buffer,
+    const optional<url_record> &base,
+    const parallel_parse_options &options) {
+  auto inputs = std::vector<std::string_view>{};
+  while (!buffer.empty()) {
+    auto line = buffer.substr(0, buffer.find('\n'));
+    buffer.remove_prefix(std::min(line.size() + 1, buffer.size()));
+    if (!line.empty() && (line.back() == '\r')) {
+      line.remove_suffix(1);
+    }
+    inputs.push_back(line);
+  }
+  return parse_parallel(inputs, base, options);
+}
+}  // namespace skyr
@@ -4,168 +4,135 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 
 #include "skyr/url_parse.hpp"
-#include <cmath>
-#include <deque>
-#include <iterator>
-#include <limits>
-#include <map>
-#include <sstream>
 #include "skyr/url_error.hpp"
 #include "skyr/url_serialize.hpp"
 #include "url_parse_impl.hpp"
 #include "url_parser_context.hpp"
+#include "url_fast_parse.hpp"
+#include "skyr/details/url_fast_scan.hpp"
 
 namespace skyr {
+namespace {
+bool is_parsed(const url_parser_context &context, url_component last) noexcept {
+  auto state = context.state;
+  switch (last) {
+    case url_component::scheme:
+      // The relative and file states only copy the scheme in once
+      // they consume a byte
+      return !context.url.scheme.empty();
+    case url_component::username:
+    case url_component::password:
+    case url_component::host:
+    case url_component::port:
+      // A file URL's host is cleared if the first path segment is a
+      // Windows drive letter
+      if (context.url.scheme.compare("file") == 0) {
+        return is_parsed(context, url_component::path);
+      }
+      return details::is_path_or_later(state);
+    case url_component::path:
+      return
+          (state == url_parse_state::query) ||
+          (state == url_parse_state::fragment);
+    case url_component::query:
+      return state == url_parse_state::fragment;
+    case url_component::fragment:
+      return false;
+  }
+  return false;
+}
+
+void clear_after(url_record &url, url_component last) {
+  if (last < url_component::path) {
+    url.path.clear();
+  }
+
+  if (last < url_component::query) {
+    url.query = nullopt;
+  }
+
+  if (last < url_component::fragment) {
+    url.fragment = nullopt;
+  }
+}
+}  // namespace
+
+namespace {
+template <class Policy>
+expected<url_record, std::error_code> parse_with_policy(
+    std::string_view input,
+    Policy &policy,
+    const optional<url_record> &base,
+    const url_record::allocator_type &alloc) {
+  auto fast_url = details::fast_parse(input);
+  if (fast_url) {
+    policy = Policy();
+    return details::make_url_record(fast_url.value(), alloc);
+  }
+
+  auto context = basic_url_parser_context<Policy>(input, details::base_url(base), nullopt, nullopt, alloc);
+  if (context.policy.failed()) {
+    return make_unexpected(context.policy.error());
+  }
+  auto url = details::parse_remaining(context);
+  policy = std::move(context.policy);
+  return url;
+}
+}  // namespace
+
 namespace details {
 expected<url_record, std::error_code> basic_parse(
-    url_record::string_type input,
+    std::string_view input,
     const optional<url_record> &base,
     const optional<url_record> &url,
-    optional<url_parse_state> state_override) {
-  using return_type = expected<url_parse_action, url_parse_errc>;
-  using url_parse_func = std::function<return_type(url_parser_context &, char)>;
-  using url_parse_funcs = std::map<url_parse_state, url_parse_func>;
-
-  auto parse_funcs = url_parse_funcs{
-      {url_parse_state::scheme_start,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_scheme_start(byte);
-       }},
-      {url_parse_state::scheme,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_scheme(byte);
-       }},
-      {url_parse_state::no_scheme,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_no_scheme(byte);
-       }},
-      {url_parse_state::special_relative_or_authority,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_special_relative_or_authority(byte);
-       }},
-      {url_parse_state::path_or_authority,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_path_or_authority(byte);
-       }},
-      {url_parse_state::relative,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_relative(byte);
-       }},
-      {url_parse_state::relative_slash,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_relative_slash(byte);
-       }},
-      {url_parse_state::special_authority_slashes,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_special_authority_slashes(byte);
-       }},
-      {url_parse_state::special_authority_ignore_slashes,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_special_authority_ignore_slashes(byte);
-       }},
-      {url_parse_state::authority,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_authority(byte);
-       }},
-      {url_parse_state::host,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_hostname(byte);
-       }},
-      {url_parse_state::hostname,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_hostname(byte);
-       }},
-      {url_parse_state::port,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_port(byte);
-       }},
-      {url_parse_state::file,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_file(byte);
-       }},
-      {url_parse_state::file_slash,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_file_slash(byte);
-       }},
-      {url_parse_state::file_host,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_file_host(byte);
-       }},
-      {url_parse_state::path_start,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_path_start(byte);
-       }},
-      {url_parse_state::path,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_path(byte);
-       }},
-      {url_parse_state::cannot_be_a_base_url_path,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_cannot_be_a_base_url(byte);
-       }},
-      {url_parse_state::query,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_query(byte);
-       }},
-      {url_parse_state::fragment,
-       [](auto &context,
-          auto byte) -> expected<url_parse_action, url_parse_errc> {
-         return context.parse_fragment(byte);
-       }}};
-
-  auto context = url_parser_context(input, base, url, state_override);
-
-  while (true) {
-    auto func = parse_funcs[context.state];
-    auto byte = context.is_eof() ? static_cast<char>(0) : *context.it;
-    auto action = func(context, byte);
-    if (!action) {
-      return make_unexpected(make_error_code(action.error()));
-    }
+    optional<url_parse_state> state_override,
+    const url_record::allocator_type &alloc) {
+  auto context = url_parser_context(input, details::base_url(base), url, state_override, alloc);
+  return details::parse_remaining(context);
+}
 
-    switch (action.value()) {
-      case url_parse_action::success:
-        return context.url;
-      case url_parse_action::increment:
-        break;
-      case url_parse_action::continue_:
-        continue;
-    }
+expected<void, std::error_code> basic_parse(
+    std::string_view input,
+    url_record &url,
+    url_parse_state state_override) {
+  auto context = url_parser_context(
+      input, nullptr, nullopt, state_override, url.get_allocator());
+  auto validation_error = url.validation_error;
+  auto sanitize_error = context.url.validation_error;
+  context.url.swap(url);
+  context.url.validation_error |= sanitize_error;
+
+  // The host state override can set the host and then fail on the
+  // port, which is the only partial change a state override makes
+  auto host = ((state_override == url_parse_state::host) && context.url.host)?
+      optional<url_record::string_type>(url_record::string_type(
+          context.url.host.value(), url.get_allocator())) :
+      optional<url_record::string_type>();
 
-    if (context.is_eof()) {
-      break;
+  auto result = details::parse_remaining(context);
+  if (!result) {
+    context.url.swap(url);
+    if (state_override == url_parse_state::host) {
+      url.host = std::move(host);
     }
-    context.increment();
+    url.validation_error = validation_error;
+    return make_unexpected(std::move(result.error()));
   }
-
-  return context.url;
+  url.swap(result.value());
+  return {};
 }
 }  // namespace details
 
 expected<url_record, std::error_code> parse(
-    url_record::string_type input,
-    const optional<url_record> &base) {
-  auto url = details::basic_parse(input, base);
+    std::string_view input,
+    const optional<url_record> &base,
+    const url_record::allocator_type &alloc) {
+  auto fast_url = details::fast_parse(input);
+  if (fast_url) {
+    return details::make_url_record(fast_url.value(), alloc);
+  }
+
+  auto url = details::basic_parse(input, base, nullopt, nullopt, alloc);
 
   if (!url) {
     return url;
@@ -181,4 +148,89 @@ expected<url_record, std::error_code> parse(
 
   return url;
 }
+
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    const url_parse_options &options,
+    const optional<url_record> &base,
+    const url_record::allocator_type &alloc) {
+  if (input.size() > options.max_input_length) {
+    return make_unexpected(make_error_code(url_parse_errc::input_too_long));
+  }
+  return parse(input, base, alloc);
+}
+
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    ignore_validation_errors policy,
+    const optional<url_record> &base,
+    const url_record::allocator_type &alloc) {
+  return parse_with_policy(input, policy, base, alloc);
+}
+
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    fail_on_validation_error policy,
+    const optional<url_record> &base,
+    const url_record::allocator_type &alloc) {
+  return parse_with_policy(input, policy, base, alloc);
+}
+
+expected<url_record, std::error_code> parse(
+    std::string_view input,
+    collect_validation_errors &policy,
+    const optional<url_record> &base,
+    const url_record::allocator_type &alloc) {
+  return parse_with_policy(input, policy, base, alloc);
+}
+
+bool is_valid_url(
+    std::string_view input,
+    const optional<url_record> &base) {
+  // The parser can't fail once it reaches the path, so the scheme,
+  // host and port are enough to tell that a common URL is valid
+  auto rest = input;
+  auto scan = details::fast_url_scan{};
+  if (details::scan_fast_origin(rest, scan)) {
+    return true;
+  }
+
+  using context_type = basic_url_parser_context<ignore_validation_errors>;
+  auto context = context_type(input, details::base_url(base), nullopt);
+  auto result = details::parse_while(context, [] (const context_type &context) {
+    return !details::is_path_or_later(context.state);
+  });
+  return static_cast<bool>(result);
+}
+
+expected<url_record, std::error_code> parse_until(
+    std::string_view input,
+    url_component last,
+    const optional<url_record> &base,
+    const url_record::allocator_type &alloc) {
+  if (last == url_component::fragment) {
+    return parse(input, base, alloc);
+  }
+
+  // A common URL's scheme, host and port are recognised without
+  // looking at the rest of the input
+  auto fast_url = (last <= url_component::port)?
+      details::fast_parse_origin(input) : details::fast_parse(input);
+  if (fast_url) {
+    auto url = details::make_url_record(fast_url.value(), alloc);
+    clear_after(url, last);
+    return url;
+  }
+
+  auto context = url_parser_context(input, details::base_url(base), nullopt, nullopt, alloc);
+  auto result = details::parse_while(context, [last] (const url_parser_context &context) {
+    return !is_parsed(context, last);
+  });
+  if (!result) {
+    return make_unexpected(std::move(result.error()));
+  }
+
+  clear_after(context.url, last);
+  return std::move(context.url);
+}
 }  // namespace skyr
@@ -7,6 +7,7 @@
 #define SKYR_URL_PARSE_IMPL_HPP
 
 #include <string>
+#include <string_view>
 #include <system_error>
 #include "skyr/optional.hpp"
 #include "skyr/expected.hpp"
@@ -65,12 +66,29 @@ namespace details {
 /// \param base An optional base URL
 /// \param url An optional `url_record`
 /// \param state_override
+/// \param alloc The allocator used by the returned record
 /// \returns A `url_record` on success and an error code on failure
 expected<url_record, std::error_code> basic_parse(
-    url_record::string_type input,
+    std::string_view input,
     const optional<url_record> &base = nullopt,
     const optional<url_record> &url = nullopt,
-    optional<url_parse_state> state_override = nullopt);
+    optional<url_parse_state> state_override = nullopt,
+    const url_record::allocator_type &alloc = url_record::allocator_type());
+
+/// Parses part of a URL into an existing record, as the setters in
+/// `skyr::url` do
+///
+/// The record is modified in place rather than copied. On failure it
+/// is left unchanged.
+///
+/// \param input The input string that will be parsed
+/// \param url The `url_record` to modify
+/// \param state_override The state to start parsing in
+/// \returns An error code on failure
+expected<void, std::error_code> basic_parse(
+    std::string_view input,
+    url_record &url,
+    url_parse_state state_override);
 }  // namespace details
 }  // namespace skyr
 
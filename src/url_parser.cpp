@@ -0,0 +1,143 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <memory_resource>
+#include "skyr/url_parser.hpp"
+#include "url_parser_context.hpp"
+#include "url_fast_parse.hpp"
+
+namespace skyr {
+namespace {
+/// The size of the arena before the parser has seen any input
+constexpr std::size_t initial_arena_size = 1024;
+
+/// Passes allocations on to the default memory resource, counting
+/// how many bytes were allocated
+class counting_resource : public std::pmr::memory_resource {
+ public:
+
+  std::size_t allocated = 0;
+
+ private:
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+/// Hands out memory from a buffer that is reused for each parse
+///
+/// If a parse needs more memory than the buffer holds, the rest
+/// comes from the default memory resource and the buffer is made
+/// big enough for it when the arena is next reset.
+class arena_resource : public std::pmr::memory_resource {
+ public:
+
+  arena_resource()
+    : size_(initial_arena_size)
+    , buffer_(std::make_unique<char[]>(size_))
+    , monotonic_(std::make_unique<std::pmr::monotonic_buffer_resource>(
+          buffer_.get(), size_, &overflow_)) {}
+
+  /// Frees everything allocated since the last reset
+  void reset() {
+    if (overflow_.allocated == 0) {
+      monotonic_->release();
+      return;
+    }
+
+    size_ = std::max(size_ * 2, size_ + overflow_.allocated);
+    monotonic_.reset();
+    buffer_ = std::make_unique<char[]>(size_);
+    overflow_.allocated = 0;
+    monotonic_ = std::make_unique<std::pmr::monotonic_buffer_resource>(
+        buffer_.get(), size_, &overflow_);
+  }
+
+ private:
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return monotonic_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {}
+
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  std::size_t size_;
+  std::unique_ptr<char[]> buffer_;
+  counting_resource overflow_;
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> monotonic_;
+};
+}  // namespace
+
+struct url_parser::impl {
+  explicit impl(optional<url_record> base)
+    : base(std::move(base))
+    , arena()
+    , url(url_record::allocator_type(&arena))
+    , context(std::string_view(), details::base_url(this->base), nullopt, nullopt, url_record::allocator_type(&arena)) {}
+
+  expected<void, std::error_code> parse(std::string_view input) {
+    // Both records must let go of the arena's memory before it is
+    // reused. They are swapped with empty records rather than
+    // assigned, because a string that is assigned a short string
+    // keeps its buffer
+    auto alloc = url_record::allocator_type(&arena);
+    url_record(alloc).swap(url);
+    url_record(alloc).swap(context.url);
+    arena.reset();
+
+    auto fast_url = details::fast_parse(input);
+    if (fast_url) {
+      url = details::make_url_record(fast_url.value(), alloc);
+      return {};
+    }
+
+    context.restart(input);
+    auto result = details::parse_remaining(context);
+    if (!result) {
+      auto error = result.error();
+      return make_unexpected(std::move(error));
+    }
+    url = std::move(result.value());
+    return {};
+  }
+
+  optional<url_record> base;
+  arena_resource arena;
+  url_record url;
+  url_parser_context context;
+};
+
+url_parser::url_parser(optional<url_record> base)
+  : impl_(std::make_unique<impl>(std::move(base))) {}
+
+url_parser::url_parser(url_parser &&other) noexcept = default;
+
+url_parser &url_parser::operator = (url_parser &&other) noexcept = default;
+
+url_parser::~url_parser() = default;
+
+expected<void, std::error_code> url_parser::parse(std::string_view input) {
+  return impl_->parse(input);
+}
+
+const url_record &url_parser::url() const noexcept {
+  return impl_->url;
+}
+}  // namespace skyr
@@ -3,39 +3,24 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
 #include <cmath>
 #include <sstream>
-#include <deque>
 #include <map>
 #include <array>
-#include <locale>
 #include <cstring>
 #include "url_parser_context.hpp"
-#include "skyr/domain.hpp"
 #include "url_schemes.hpp"
+#include "url_host.hpp"
 #include "skyr/percent_encode.hpp"
-#include "skyr/ipv4_address.hpp"
-#include "skyr/ipv6_address.hpp"
+#include "skyr/details/char_class.hpp"
+#include "url_sanitize.hpp"
 #include "algorithms.hpp"
 
 namespace skyr {
 namespace {
-bool remove_tabs_and_newlines(std::string &input) {
-  auto first = begin(input), last = end(input);
-  auto it = std::remove_if(
-      first, last, [] (auto byte) -> bool { return is_in(byte, "\t\r\n"); });
-  input.erase(it, end(input));
-  return it == last;
-}
-
-inline bool is_forbidden_host_point(std::string_view::value_type byte) noexcept {
-  static const char forbidden[] = "\0\t\n\r #%/:?@[\\]";
-  const char *first = forbidden, *last = forbidden + sizeof(forbidden);
-  return last != std::find(first, last, byte);
-}
-
 bool remaining_starts_with(
     std::string_view::const_iterator first,
     std::string_view::const_iterator last,
@@ -46,75 +31,20 @@ bool remaining_starts_with(
   return starts_with(++first, last, chars);
 }
 
-expected<std::string, url_parse_errc> parse_opaque_host(std::string_view input) {
-  auto first = begin(input), last = end(input);
-  auto it = std::find_if(
-      first, last, [] (auto byte) -> bool {
-        return (byte != '%') && is_forbidden_host_point(byte);
-      });
-  if (it != last) {
-      // result.validation_error = true;
-      return make_unexpected(url_parse_errc::forbidden_host_point);
-    }
-
-  auto output = std::string();
-  for (auto c : input) {
-    output += percent_encode_byte(c);
-  }
-  return output;
-}
-
-expected<std::string, url_parse_errc> parse_host(
-    std::string_view input, bool is_not_special = false) {
-  if (!input.empty() && (input.front() == '[')) {
-    if (input.back() != ']') {
-      // result.validation_error = true;
-      return make_unexpected(url_parse_errc::invalid_ipv6_address);
-    }
-
-    auto view = std::string_view(input);
-    view.remove_prefix(1);
-    view.remove_suffix(1);
-    auto ipv6_address = parse_ipv6_address(view);
-    if (ipv6_address) {
-      return "[" + ipv6_address.value().to_string() + "]";
-    }
-    else {
-      return make_unexpected(url_parse_errc::invalid_ipv6_address);
-    }
-  }
-
-  if (is_not_special) {
-    return parse_opaque_host(input);
-  }
-
-  auto domain = percent_decode(input);
-  if (!domain) {
-    return make_unexpected(url_parse_errc::cannot_decode_host_point);
-  }
-
-  auto ascii_domain = domain_to_ascii(domain.value());
-  if (!ascii_domain) {
-    return make_unexpected(url_parse_errc::domain_error);
-  }
-
-  auto it = std::find_if(
-      begin(ascii_domain.value()), end(ascii_domain.value()), is_forbidden_host_point);
-  if (it != end(ascii_domain.value())) {
-    // result.validation_error = true;
-    return make_unexpected(url_parse_errc::domain_error);
+/// Parses a host and stores it in the record, without a temporary
+/// copy if it is already a plain ASCII domain
+expected<void, url_parse_errc> set_host(url_record &url, std::string_view input) {
+  if (url.is_special() && details::is_plain_ascii_domain(input)) {
+    url.host = url.make_string(input);
+    return {};
   }
 
-  auto host = parse_ipv4_address(ascii_domain.value());
+  auto host = details::parse_host(input, !url.is_special());
   if (!host) {
-    if (host.error() == make_error_code(ipv4_address_errc::overflow)) {
-      return make_unexpected(url_parse_errc::invalid_ipv4_address);
-    }
-    else {
-      return ascii_domain.value();
-    }
+    return make_unexpected(std::move(host.error()));
   }
-  return host.value().to_string();
+  url.host = url.make_string(host.value().name);
+  return {};
 }
 
 bool is_valid_port(std::string_view port) noexcept {
@@ -132,8 +62,7 @@ bool is_valid_port(std::string_view port) noexcept {
 }
 
 bool is_url_code_point(char byte) noexcept {
-  return
-      std::isalnum(byte, std::locale::classic()) || is_in(byte, "!$&'()*+,-./:/=?@_~");
+  return details::is_in_class(byte, details::char_class::url_code_point);
 }
 
 bool is_windows_drive_letter(
@@ -143,7 +72,7 @@ bool is_windows_drive_letter(
     return false;
   }
 
-  if (!std::isalpha(*it, std::locale::classic())) {
+  if (!details::is_in_class(*it, details::char_class::alpha)) {
     return false;
   }
 
@@ -162,31 +91,48 @@ inline bool is_windows_drive_letter(std::string_view segment) noexcept {
   return is_windows_drive_letter(begin(segment), end(segment));
 }
 
-bool is_single_dot_path_segment(std::string_view segment) noexcept {
-  auto lower = std::string(segment);
-  std::transform(begin(lower), end(lower), begin(lower),
-                 [] (auto byte) -> decltype(byte) {
-    return std::tolower(byte, std::locale::classic());
-  });
+/// \returns `true` if `segment` is `lower`, ignoring the case of
+///          ASCII letters
+bool equals_ignoring_case(std::string_view segment, std::string_view lower) noexcept {
+  return
+      (segment.size() == lower.size()) &&
+      std::equal(begin(segment), end(segment), begin(lower),
+                 [] (auto byte, auto lower_byte) -> bool {
+                   return details::to_ascii_lower(byte) == lower_byte;
+                 });
+}
 
-  return ((lower == ".") || (lower == "%2e"));
+bool is_single_dot_path_segment(std::string_view segment) noexcept {
+  return
+      equals_ignoring_case(segment, ".") ||
+      equals_ignoring_case(segment, "%2e");
 }
 
 bool is_double_dot_path_segment(std::string_view segment) noexcept {
-  auto lower = std::string(segment);
-  std::transform(begin(lower), end(lower), begin(lower),
-                 [] (auto byte) -> decltype(byte) {
-    return std::tolower(byte, std::locale::classic());
-  });
-
   return (
-      (lower == "..") ||
-      (lower == ".%2e") ||
-      (lower == "%2e.") ||
-      (lower == "%2e%2e"));
+      equals_ignoring_case(segment, "..") ||
+      equals_ignoring_case(segment, ".%2e") ||
+      equals_ignoring_case(segment, "%2e.") ||
+      equals_ignoring_case(segment, "%2e%2e"));
+}
+
+/// Reserves room in the path for the rest of the input, up to the
+/// query or fragment, so that it's usually allocated once
+///
+/// Percent encoding can make the path longer than the input, and
+/// dot segments can make it shorter, so this is only an estimate.
+void reserve_path(url_path &path, std::string_view input, bool is_special) {
+  input = input.substr(0, input.find_first_of("?#"));
+  auto separators = std::count_if(
+      begin(input), end(input), [is_special] (auto byte) {
+        return (byte == '/') || (is_special && (byte == '\\'));
+      });
+  path.reserve(
+      path.joined().size() + input.size(),
+      path.size() + static_cast<std::size_t>(separators) + 1);
 }
 
-void shorten_path(std::string_view scheme, std::vector<std::string> &path) {
+void shorten_path(std::string_view scheme, url_path &path) {
   if (path.empty()) {
     return;
   }
@@ -201,49 +147,82 @@ void shorten_path(std::string_view scheme, std::vector<std::string> &path) {
 }
 } // namespace
 
-url_parser_context::url_parser_context(
-    std::string input,
-    const optional<url_record> &base,
+template <class Policy>
+basic_url_parser_context<Policy>::basic_url_parser_context(
+    std::string_view input,
+    const url_record *base,
     const optional<url_record> &url,
-    optional<url_parse_state> state_override)
-    : input(input)
+    optional<url_parse_state> state_override,
+    const url_record::allocator_type &alloc)
+    : input()
+    , view(input)
     , base(base)
-    , url(url? url.value() : url_record{})
+    , url(url? url_record(url.value(), alloc) : url_record(alloc))
     , state(state_override? state_override.value() : url_parse_state::scheme_start)
     , state_override(state_override)
     , buffer()
     , at_flag(false)
     , square_braces_flag(false)
-    , password_token_seen_flag(false) {
-  this->url.validation_error |= !remove_leading_whitespace(this->input);
-  this->url.validation_error |= !remove_trailing_whitespace(this->input);
-  this->url.validation_error |= !remove_tabs_and_newlines(this->input);
+    , password_token_seen_flag(false)
+    , policy() {
+  sanitize();
+}
+
+template <class Policy>
+void basic_url_parser_context<Policy>::restart(std::string_view input) {
+  view = input;
+  url = url_record(url.get_allocator());
+  state = url_parse_state::scheme_start;
+  state_override = nullopt;
+  buffer.clear();
+  at_flag = false;
+  square_braces_flag = false;
+  password_token_seen_flag = false;
+  policy = Policy();
+  sanitize();
+}
+
+template <class Policy>
+void basic_url_parser_context<Policy>::sanitize() {
+  auto sanitized = details::sanitize_input(view, this->input);
+  view = sanitized.view;
+
+  if (sanitized.has_leading_c0_control_or_space) {
+    policy.report(
+        this->url, url_validation_errc::leading_or_trailing_c0_control_or_space, 0);
+  }
+  if (sanitized.tab_or_newline != std::string_view::npos) {
+    policy.report(this->url, url_validation_errc::tab_or_newline, sanitized.tab_or_newline);
+  }
+  if (sanitized.has_trailing_c0_control_or_space) {
+    policy.report(
+        this->url, url_validation_errc::leading_or_trailing_c0_control_or_space, view.size());
+  }
 
-  view = std::string_view(this->input);
   it = begin(view);
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_scheme_start(char byte) {
-  if (std::isalpha(byte, std::locale::classic())) {
-    auto lower = std::tolower(byte, std::locale::classic());
-    buffer.push_back(lower);
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_scheme_start(char byte) {
+  if (details::is_in_class(byte, details::char_class::alpha)) {
+    buffer.push_back(details::to_ascii_lower(byte));
     state = url_parse_state::scheme;
   } else if (!state_override) {
     state = url_parse_state::no_scheme;
     reset();
     return url_parse_action::continue_;
   } else {
-    url.validation_error = true;
+    report(url_validation_errc::invalid_url_unit);
     return make_unexpected(url_parse_errc::invalid_scheme_character);
   }
 
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_scheme(char byte) {
-  if (std::isalnum(byte, std::locale::classic()) || is_in(byte, "+-.")) {
-    auto lower = std::tolower(byte, std::locale::classic());
-    buffer.push_back(lower);
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_scheme(char byte) {
+  if (details::is_in_class(byte, details::char_class::scheme)) {
+    buffer.push_back(details::to_ascii_lower(byte));
   } else if (byte == ':') {
     if (state_override) {
       if (url.is_special() && !details::is_special(buffer)) {
@@ -272,11 +251,11 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_scheme(char
     buffer.clear();
 
     if (url.scheme.compare("file") == 0) {
-      if (!remaining_starts_with(it, end(view), "//")) {
-        url.validation_error = true;
+      if (Policy::reports_errors && !remaining_starts_with(it, end(view), "//")) {
+        report(url_validation_errc::special_scheme_missing_following_solidus);
       }
       state = url_parse_state::file;
-    } else if (url.is_special() && base && (base.value().scheme == url.scheme)) {
+    } else if (url.is_special() && base && (base->scheme == url.scheme)) {
       state = url_parse_state::special_relative_or_authority;
     } else if (url.is_special()) {
       state = url_parse_state::special_authority_slashes;
@@ -301,19 +280,20 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_scheme(char
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_no_scheme(char byte) {
-  if (!base || (base.value().cannot_be_a_base_url && (byte != '#'))) {
-    url.validation_error = true;
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_no_scheme(char byte) {
+  if (!base || (base->cannot_be_a_base_url && (byte != '#'))) {
+    report(url_validation_errc::missing_scheme_non_relative_url);
     return make_unexpected(url_parse_errc::not_an_absolute_url_with_fragment);
-  } else if (base.value().cannot_be_a_base_url && (byte == '#')) {
-    url.scheme = base.value().scheme;
-    url.path = base.value().path;
-    url.query = base.value().query;
-    url.fragment = std::string();
+  } else if (base->cannot_be_a_base_url && (byte == '#')) {
+    url.scheme = base->scheme;
+    url.path = base->path;
+    details::assign(url.query, base->query, url.get_allocator());
+    url.fragment = url.make_string();
 
     url.cannot_be_a_base_url = true;
     state = url_parse_state::fragment;
-  } else if (base.value().scheme.compare("file") != 0) {
+  } else if (base->scheme.compare("file") != 0) {
     state = url_parse_state::relative;
     reset();
     return url_parse_action::continue_;
@@ -325,19 +305,21 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_no_scheme(c
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_special_relative_or_authority(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_special_relative_or_authority(char byte) {
   if ((byte == '/') && remaining_starts_with(it, end(view), "/")) {
     increment();
     state = url_parse_state::special_authority_ignore_slashes;
   } else {
-    url.validation_error = true;
+    report(url_validation_errc::special_scheme_missing_following_solidus);
     decrement();
     state = url_parse_state::relative;
   }
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_path_or_authority(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_path_or_authority(char byte) {
   if (byte == '/') {
     state = url_parse_state::authority;
   } else {
@@ -347,45 +329,46 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_path_or_aut
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_relative(char byte) {
-  url.scheme = base.value().scheme;
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_relative(char byte) {
+  url.scheme = base->scheme;
   if (is_eof()) {
-    url.username = base.value().username;
-    url.password = base.value().password;
-    url.host = base.value().host;
-    url.port = base.value().port;
-    url.path = base.value().path;
-    url.query = base.value().query;
+    url.username = base->username;
+    url.password = base->password;
+    details::assign(url.host, base->host, url.get_allocator());
+    url.port = base->port;
+    url.path = base->path;
+    details::assign(url.query, base->query, url.get_allocator());
   }
   else if (byte == '/') {
     state = url_parse_state::relative_slash;
   } else if (byte == '?') {
-    url.username = base.value().username;
-    url.password = base.value().password;
-    url.host = base.value().host;
-    url.port = base.value().port;
-    url.path = base.value().path;
-    url.query = std::string();
+    url.username = base->username;
+    url.password = base->password;
+    details::assign(url.host, base->host, url.get_allocator());
+    url.port = base->port;
+    url.path = base->path;
+    url.query = url.make_string();
     state = url_parse_state::query;
   } else if (byte == '#') {
-    url.username = base.value().username;
-    url.password = base.value().password;
-    url.host = base.value().host;
-    url.port = base.value().port;
-    url.path = base.value().path;
-    url.query = base.value().query;
-    url.fragment = std::string();
+    url.username = base->username;
+    url.password = base->password;
+    details::assign(url.host, base->host, url.get_allocator());
+    url.port = base->port;
+    url.path = base->path;
+    details::assign(url.query, base->query, url.get_allocator());
+    url.fragment = url.make_string();
     state = url_parse_state::fragment;
   } else {
     if (url.is_special() && (byte == '\\')) {
-      url.validation_error = true;
+      report(url_validation_errc::invalid_reverse_solidus);
       state = url_parse_state::relative_slash;
     } else {
-      url.username = base.value().username;
-      url.password = base.value().password;
-      url.host = base.value().host;
-      url.port = base.value().port;
-      url.path = base.value().path;
+      url.username = base->username;
+      url.password = base->password;
+      details::assign(url.host, base->host, url.get_allocator());
+      url.port = base->port;
+      url.path = base->path;
       if (!url.path.empty()) {
         url.path.pop_back();
       }
@@ -402,10 +385,11 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_relative(ch
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_relative_slash(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_relative_slash(char byte) {
   if (url.is_special() && ((byte == '/') || (byte == '\\'))) {
     if (byte == '\\') {
-      url.validation_error = true;
+      report(url_validation_errc::invalid_reverse_solidus);
     }
     state = url_parse_state::special_authority_ignore_slashes;
   }
@@ -413,10 +397,10 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_relative_sl
     state = url_parse_state::authority;
   }
   else {
-    url.username = base.value().username;
-    url.password = base.value().password;
-    url.host = base.value().host;
-    url.port = base.value().port;
+    url.username = base->username;
+    url.password = base->password;
+    details::assign(url.host, base->host, url.get_allocator());
+    url.port = base->port;
     state = url_parse_state::path;
     decrement();
   }
@@ -424,12 +408,13 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_relative_sl
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_special_authority_slashes(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_special_authority_slashes(char byte) {
   if ((byte == '/') && remaining_starts_with(it, end(view), "/")) {
     increment();
     state = url_parse_state::special_authority_ignore_slashes;
   } else {
-    url.validation_error = true;
+    report(url_validation_errc::special_scheme_missing_following_solidus);
     decrement();
     state = url_parse_state::special_authority_ignore_slashes;
   }
@@ -437,31 +422,40 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_special_aut
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_special_authority_ignore_slashes(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_special_authority_ignore_slashes(char byte) {
   if ((byte != '/') && (byte != '\\')) {
     decrement();
     state = url_parse_state::authority;
   } else {
-    url.validation_error = true;
+    report(url_validation_errc::special_scheme_missing_following_solidus);
   }
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_authority(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_authority(char byte) {
   if (byte == '@') {
-    url.validation_error = true;
+    report(url_validation_errc::invalid_credentials);
     if (at_flag) {
-      buffer = "%40" + buffer;
+      // Appending the encoded '@' avoids copying the buffer, which
+      // would make an input with many '@' characters quadratic
+      if (password_token_seen_flag) {
+        url.password += "%40";
+      } else {
+        url.username += "%40";
+      }
     }
     at_flag = true;
 
+    static const auto excludes = userinfo_set();
     for (auto byte : buffer) {
       if (byte == ':' && !password_token_seen_flag) {
         password_token_seen_flag = true;
         continue;
       }
 
-      auto pct_encoded = percent_encode_byte(byte, userinfo_set());
+      auto pct_encoded = percent_encode_byte(byte, excludes);
       if (password_token_seen_flag) {
         url.password += pct_encoded;
       } else {
@@ -473,7 +467,7 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_authority(c
       ((is_eof()) || (byte == '/') || (byte == '?') || (byte == '#')) ||
           (url.is_special() && (byte == '\\'))) {
     if (at_flag && buffer.empty()) {
-      url.validation_error = true;
+      report(url_validation_errc::host_missing);
       return make_unexpected(url_parse_errc::empty_hostname);
     }
     restart_from_buffer();
@@ -487,7 +481,8 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_authority(c
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_hostname(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_hostname(char byte) {
   if (state_override && (url.scheme.compare("file") == 0)) {
     state = url_parse_state::file_host;
     if (it == begin(view)) {
@@ -496,15 +491,14 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_hostname(ch
     decrement();
   } else if ((byte == ':') && !square_braces_flag) {
     if (buffer.empty()) {
-      url.validation_error = true;
+      report(url_validation_errc::host_missing);
       return make_unexpected(url_parse_errc::empty_hostname);
     }
 
-    auto host = parse_host(buffer, !url.is_special());
+    auto host = set_host(url, buffer);
     if (!host) {
       return make_unexpected(std::move(host.error()));
     }
-    url.host = host.value();
     buffer.clear();
     state = url_parse_state::port;
 
@@ -520,22 +514,21 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_hostname(ch
     decrement();
 
     if (url.is_special() && buffer.empty()) {
-      url.validation_error = true;
+      report(url_validation_errc::host_missing);
       return make_unexpected(url_parse_errc::empty_hostname);
     }
     else if (
         state_override &&
         buffer.empty() &&
         (url.includes_credentials() || url.port)) {
-      url.validation_error = true;
+      report(url_validation_errc::host_missing);
       return url_parse_action::continue_;
     }
 
-    auto host = parse_host(buffer, !url.is_special());
+    auto host = set_host(url, buffer);
     if (!host) {
       return make_unexpected(std::move(host.error()));
     }
-    url.host = host.value();
     buffer.clear();
     state = url_parse_state::path_start;
 
@@ -553,8 +546,9 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_hostname(ch
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_port(char byte) {
-  if (std::isdigit(byte, std::locale::classic())) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_port(char byte) {
+  if (details::is_in_class(byte, details::char_class::digit)) {
     buffer += byte;
   } else if (
       ((is_eof()) || (byte == '/') || (byte == '?') || (byte == '#')) ||
@@ -562,7 +556,7 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_port(char b
           state_override) {
     if (!buffer.empty()) {
       if (!is_valid_port(buffer)) {
-        url.validation_error = true;
+        report(url_validation_errc::port_out_of_range);
         return make_unexpected(url_parse_errc::invalid_port);
       }
 
@@ -584,46 +578,47 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_port(char b
     decrement();
     state = url_parse_state::path_start;
   } else {
-    url.validation_error = true;
+    report(url_validation_errc::port_invalid);
     return make_unexpected(url_parse_errc::invalid_port);
   }
 
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_file(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_file(char byte) {
   url.scheme = "file";
 
   if ((byte == '/') || (byte == '\\')) {
     if (byte == '\\') {
-      url.validation_error = true;
+      report(url_validation_errc::invalid_reverse_solidus);
     }
     state = url_parse_state::file_slash;
-  } else if (base && (base.value().scheme.compare("file") == 0)) {
+  } else if (base && (base->scheme.compare("file") == 0)) {
     if (is_eof()) {
-      url.host = base.value().host;
-      url.path = base.value().path;
-      url.query = base.value().query;
+      details::assign(url.host, base->host, url.get_allocator());
+      url.path = base->path;
+      details::assign(url.query, base->query, url.get_allocator());
     }
     else if (byte == '?') {
-      url.host = base.value().host;
-      url.path = base.value().path;
-      url.query = std::string();
+      details::assign(url.host, base->host, url.get_allocator());
+      url.path = base->path;
+      url.query = url.make_string();
       state = url_parse_state::query;
     } else if (byte == '#') {
-      url.host = base.value().host;
-      url.path = base.value().path;
-      url.query = base.value().query;
-      url.fragment = std::string();
+      details::assign(url.host, base->host, url.get_allocator());
+      url.path = base->path;
+      details::assign(url.query, base->query, url.get_allocator());
+      url.fragment = url.make_string();
       state = url_parse_state::fragment;
     } else {
       if (!is_windows_drive_letter(it, end(view))) {
-        url.host = base.value().host;
-        url.path = base.value().path;
+        details::assign(url.host, base->host, url.get_allocator());
+        url.path = base->path;
         shorten_path(url.scheme, url.path);
       }
       else {
-        url.validation_error = true;
+        report(url_validation_errc::file_invalid_windows_drive_letter);
       }
       state = url_parse_state::path;
       if (it == begin(view)) {
@@ -642,19 +637,20 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_file(char b
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_file_slash(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_file_slash(char byte) {
   if ((byte == '/') || (byte == '\\')) {
     if (byte == '\\') {
-      url.validation_error = true;
+      report(url_validation_errc::invalid_reverse_solidus);
     }
     state = url_parse_state::file_host;
   } else {
     if (base &&
-            ((base.value().scheme.compare("file") == 0) && !is_windows_drive_letter(it, end(view)))) {
-      if (!base.value().path.empty() && is_windows_drive_letter(base.value().path[0])) {
-        url.path.push_back(base.value().path[0]);
+            ((base->scheme.compare("file") == 0) && !is_windows_drive_letter(it, end(view)))) {
+      if (!base->path.empty() && is_windows_drive_letter(base->path[0])) {
+        url.path.push_back(base->path[0]);
       } else {
-        url.host = base.value().host;
+        details::assign(url.host, base->host, url.get_allocator());
       }
     }
 
@@ -665,7 +661,8 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_file_slash(
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_file_host(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_file_host(char byte) {
   if ((is_eof()) || (byte == '/') || (byte == '\\') || (byte == '?') || (byte == '#')) {
     bool at_begin = (it == begin(view));
     if (!at_begin) {
@@ -673,10 +670,10 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_file_host(c
     }
 
     if (!state_override && is_windows_drive_letter(buffer)) {
-      url.validation_error = true;
+      report(url_validation_errc::file_invalid_windows_drive_letter_host);
       state = url_parse_state::path;
     } else if (buffer.empty()) {
-      url.host = std::string();
+      url.host = url.make_string();
 
       if (state_override) {
         return url_parse_action::success;
@@ -684,15 +681,14 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_file_host(c
 
       state = url_parse_state::path_start;
     } else {
-      auto host = parse_host(buffer, !url.is_special());
+      auto host = set_host(url, buffer);
       if (!host) {
         return make_unexpected(std::move(host.error()));
       }
 
-      if (host.value() == "localhost") {
-        host.value().clear();
+      if (url.host.value() == "localhost") {
+        url.host.value().clear();
       }
-      url.host = host.value();
 
       if (state_override) {
         return url_parse_action::success;
@@ -709,13 +705,15 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_file_host(c
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_path_start(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_path_start(char byte) {
   bool at_begin = (it == begin(view));
   if (url.is_special()) {
     if (byte == '\\') {
-      url.validation_error = true;
+      report(url_validation_errc::invalid_reverse_solidus);
     }
     state = url_parse_state::path;
+    reserve_path(url.path, view.substr(std::distance(begin(view), it)), true);
     if ((byte != '/') && (byte != '\\')) {
       if (at_begin) {
         return url_parse_action::continue_;
@@ -723,13 +721,14 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_path_start(
       decrement();
     }
   } else if (!state_override && (byte == '?')) {
-    url.query = std::string();
+    url.query = url.make_string();
     state = url_parse_state::query;
   } else if (!state_override && (byte == '#')) {
-    url.fragment = std::string();
+    url.fragment = url.make_string();
     state = url_parse_state::fragment;
   } else if (!is_eof()) {
     state = url_parse_state::path;
+    reserve_path(url.path, view.substr(std::distance(begin(view), it)), false);
     if (byte != '/') {
       if (at_begin) {
         return url_parse_action::continue_;
@@ -740,12 +739,13 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_path_start(
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_path(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_path(char byte) {
   if (((is_eof()) || (byte == '/')) ||
       (url.is_special() && (byte == '\\')) ||
       (!state_override && ((byte == '?') || (byte == '#')))) {
     if (url.is_special() && (byte == '\\')) {
-      url.validation_error = true;
+      report(url_validation_errc::invalid_reverse_solidus);
     }
 
     if (is_double_dot_path_segment(buffer)) {
@@ -761,78 +761,99 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_path(char b
       if ((url.scheme.compare("file") == 0) &&
           url.path.empty() && is_windows_drive_letter(buffer)) {
         if (!url.host || !url.host.value().empty()) {
-          url.validation_error = true;
-          url.host = std::string();
+          report(url_validation_errc::file_invalid_windows_drive_letter_host);
+          url.host = url.make_string();
         }
         buffer[1] = ':';
       }
 
-      url.path.push_back(buffer);
+      url.path.emplace_back(buffer);
     }
 
     buffer.clear();
 
     if ((url.scheme.compare("file") == 0) && (is_eof() || (byte == '?') || (byte == '#'))) {
-      auto path = std::deque<std::string>(begin(url.path), end(url.path));
-      while ((path.size() > 1) && path[0].empty()) {
-        url.validation_error = true;
-        path.pop_front();
+      auto first = url.path.begin();
+      while ((std::distance(first, url.path.end()) > 1) && (*first).empty()) {
+        report(url_validation_errc::file_empty_path_segment);
+        ++first;
       }
-      url.path.assign(begin(path), end(path));
+      url.path.erase(url.path.begin(), first);
     }
 
     if (byte == '?') {
-      url.query = std::string();
+      url.query = url.make_string();
       state = url_parse_state::query;
     }
 
     if (byte == '#') {
-      url.fragment = std::string();
+      url.fragment = url.make_string();
       state = url_parse_state::fragment;
     }
   } else {
-    if (!is_url_code_point(byte) && (byte != '%')) {
-      url.validation_error = true;
+    auto run = safe_run<
+        '"', '#', '%', '/', ';', '<', '>', '?', '[', '\\', ']', '^', '`', '{', '|', '}'>();
+    if (!run.empty()) {
+      buffer.append(run.data(), run.size());
+      skip_run(run);
+      return url_parse_action::increment;
+    }
+
+    if (Policy::reports_errors && !is_url_code_point(byte) && (byte != '%')) {
+      report(url_validation_errc::invalid_url_unit);
     }
 
-    buffer += percent_encode_byte(byte, path_set());
+    static const auto excludes = path_set();
+    buffer += percent_encode_byte(byte, excludes);
   }
 
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_cannot_be_a_base_url(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_cannot_be_a_base_url(char byte) {
   if (byte == '?') {
-    url.query = std::string();
+    url.query = url.make_string();
     state = url_parse_state::query;
   } else if (byte == '#') {
-    url.fragment = std::string();
+    url.fragment = url.make_string();
     state = url_parse_state::fragment;
   } else {
-    if (!is_eof() && !is_url_code_point(byte) && (byte != '%')) {
-      url.validation_error = true;
-    }
-    else if ((byte == '%') && !is_percent_encoded(
-        std::string_view(std::addressof(*it), std::distance(it, end(view))))) {
-      url.validation_error = true;
+    if (Policy::reports_errors) {
+      if (!is_eof() && !is_url_code_point(byte) && (byte != '%')) {
+        report(url_validation_errc::invalid_url_unit);
+      }
+      else if ((byte == '%') && !is_percent_encoded(
+          std::string_view(std::addressof(*it), std::distance(it, end(view))))) {
+        report(url_validation_errc::invalid_url_unit);
+      }
     }
     if (!is_eof()) {
-      url.path[0] += percent_encode_byte(byte);
+      url.path.append_to_back(percent_encode_byte(byte));
     }
   }
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_query(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_query(char byte) {
   if (!state_override && (byte == '#')) {
-    url.fragment = std::string();
+    url.fragment = url.make_string();
     state = url_parse_state::fragment;
   } else if (!is_eof()) {
-    if ((byte < '!') ||
-        (byte > '~') ||
-        (is_in(byte, "\"#<>")) ||
-        ((byte == '\'') && url.is_special())) {
-      url.query.value() += percent_encode_byte(byte, query_set());
+    auto is_special = url.is_special();
+    auto run = is_special?
+        safe_run<'"', '#', '<', '>', '\''>() : safe_run<'"', '#', '<', '>'>();
+    if (!run.empty()) {
+      url.query.value().append(run.data(), run.size());
+      skip_run(run);
+      return url_parse_action::increment;
+    }
+
+    if (details::is_in_class(byte, details::char_class::query_state_percent_encode) ||
+        ((byte == '\'') && is_special)) {
+      static const auto excludes = query_set();
+      url.query.value() += percent_encode_byte(byte, excludes);
     } else {
       url.query.value().push_back(byte);
     }
@@ -840,12 +861,29 @@ expected<url_parse_action, url_parse_errc> url_parser_context::parse_query(char
   return url_parse_action::increment;
 }
 
-expected<url_parse_action, url_parse_errc> url_parser_context::parse_fragment(char byte) {
+template <class Policy>
+expected<url_parse_action, url_parse_errc> basic_url_parser_context<Policy>::parse_fragment(char byte) {
+  if (is_eof()) {
+    return url_parse_action::increment;
+  }
+
+  auto run = safe_run<'"', '<', '>', '`'>();
+  if (!run.empty()) {
+    url.fragment.value().append(run.data(), run.size());
+    skip_run(run);
+    return url_parse_action::increment;
+  }
+
   if (byte == '\0') {
-    url.validation_error = true;
+    report(url_validation_errc::invalid_url_unit);
   } else {
-    url.fragment.value() += percent_encode_byte(byte, fragment_set());
+    static const auto excludes = fragment_set();
+    url.fragment.value() += percent_encode_byte(byte, excludes);
   }
   return url_parse_action::increment;
 }
+template class basic_url_parser_context<flag_validation_errors>;
+template class basic_url_parser_context<ignore_validation_errors>;
+template class basic_url_parser_context<fail_on_validation_error>;
+template class basic_url_parser_context<collect_validation_errors>;
 }  // namespace skyr
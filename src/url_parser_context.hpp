@@ -7,32 +7,58 @@
 #define SKYR_URL_CONTEXT_HPP
 
 #include <cassert>
+#include <memory>
 #include <string_view>
+#include <system_error>
+#include <utility>
 #include <skyr/optional.hpp>
 #include <skyr/expected.hpp>
 #include "skyr/url_error.hpp"
 #include <skyr/url_record.hpp>
+#include <skyr/url_validation_policy.hpp>
 #include "url_parse_impl.hpp"
+#include "url_scan.hpp"
 
 namespace skyr {
+namespace details {
+/// \returns A pointer to the base URL, or `nullptr` if there isn't
+///          one
+inline const url_record *base_url(const optional<url_record> &base) noexcept {
+  return base? std::addressof(base.value()) : nullptr;
+}
+
+/// The parser context keeps a pointer to the base URL, so it can't
+/// be a temporary
+const url_record *base_url(const optional<url_record> &&base) = delete;
+}  // namespace details
+
 enum class url_parse_action {
   success = 0,
   increment,
   continue_,
 };
 
-class url_parser_context {
+/// Holds the state of the parser
+///
+/// \tparam Policy The validation policy, which is told about each
+///         validation error
+template <class Policy>
+class basic_url_parser_context {
 
  private:
 
+  /// Holds a sanitized copy of the input, only when tabs or
+  /// newlines had to be removed
   std::string input;
+  /// The (possibly sanitized) input being parsed
   std::string_view view;
 
  public:
 
   std::string_view::const_iterator it;
 
-  optional<url_record> base;
+  /// The base URL, or `nullptr` if there isn't one
+  const url_record *base;
   url_record url;
 
   url_parse_state state;
@@ -44,11 +70,14 @@ class url_parser_context {
   bool square_braces_flag;
   bool password_token_seen_flag;
 
-  url_parser_context(
-      std::string input,
-      const optional<url_record> &base,
+  Policy policy;
+
+  basic_url_parser_context(
+      std::string_view input,
+      const url_record *base,
       const optional<url_record> &url,
-      optional<url_parse_state> state_override = skyr::nullopt);
+      optional<url_parse_state> state_override = skyr::nullopt,
+      const url_record::allocator_type &alloc = url_record::allocator_type());
 
   bool is_eof() const noexcept {
     return it == end(view);
@@ -68,10 +97,61 @@ class url_parser_context {
     it = begin(view);
   }
 
+  /// Starts parsing a new input from the scheme start state
+  ///
+  /// The scratch buffers keep their capacity, and the record is
+  /// cleared but keeps its allocator.
+  ///
+  /// \param input The input string, which must stay valid while it
+  ///        is being parsed
+  void restart(std::string_view input);
+
+  /// Continues parsing from a position in a different input, which
+  /// must already be sanitized
+  ///
+  /// \param input The input, which must stay valid while it is
+  ///        being parsed
+  /// \param offset The position in `input` of the next byte
+  void resume(std::string_view input, std::size_t offset = 0) noexcept {
+    view = input;
+    it = begin(view) + offset;
+  }
+
   void restart_from_buffer() noexcept {
     it = it - buffer.size() - 1;
   }
 
+  /// Tells the validation policy about a validation error at the
+  /// current position
+  ///
+  /// \param code The validation error
+  void report(url_validation_errc code) {
+    policy.report(url, code, static_cast<std::size_t>(std::distance(begin(view), it)));
+  }
+
+  /// Finds the run of bytes, starting at the current position, that
+  /// can be appended to the output without percent encoding
+  ///
+  /// \tparam Bytes Bytes that end the run, in addition to C0
+  ///         controls, space, DEL and non-ASCII bytes
+  /// \returns The run, which is empty if the current byte ends it
+  template <char... Bytes>
+  std::string_view safe_run() const noexcept {
+    assert(it != end(view));
+    auto first = std::addressof(*it), last = view.data() + view.size();
+    return std::string_view(
+        first, details::find_run_end<Bytes...>(first, last) - first);
+  }
+
+  /// Moves the pointer to the last byte of a run, so that the next
+  /// increment moves past it
+  ///
+  /// \param run A non-empty run returned by `safe_run`
+  void skip_run(std::string_view run) noexcept {
+    assert(!run.empty());
+    it += run.size() - 1;
+  }
+
   expected<url_parse_action, url_parse_errc> parse_scheme_start(char byte);
   expected<url_parse_action, url_parse_errc> parse_scheme(char byte);
   expected<url_parse_action, url_parse_errc> parse_no_scheme(char byte);
@@ -93,7 +173,148 @@ class url_parser_context {
   expected<url_parse_action, url_parse_errc> parse_query(char byte);
   expected<url_parse_action, url_parse_errc> parse_fragment(char byte);
 
+ private:
+
+  void sanitize();
+
 };
+
+extern template class basic_url_parser_context<flag_validation_errors>;
+extern template class basic_url_parser_context<ignore_validation_errors>;
+extern template class basic_url_parser_context<fail_on_validation_error>;
+extern template class basic_url_parser_context<collect_validation_errors>;
+
+/// The parser context with the default validation policy
+using url_parser_context = basic_url_parser_context<flag_validation_errors>;
+
+namespace details {
+/// Runs the parser state for the current byte
+///
+/// \param context The parser context
+/// \param byte The current byte, or `0` at the end of the input
+/// \returns The next action, or an error
+template <class Policy>
+inline expected<url_parse_action, url_parse_errc> parse_next(
+    basic_url_parser_context<Policy> &context, char byte) {
+  switch (context.state) {
+    case url_parse_state::scheme_start:
+      return context.parse_scheme_start(byte);
+    case url_parse_state::scheme:
+      return context.parse_scheme(byte);
+    case url_parse_state::no_scheme:
+      return context.parse_no_scheme(byte);
+    case url_parse_state::special_relative_or_authority:
+      return context.parse_special_relative_or_authority(byte);
+    case url_parse_state::path_or_authority:
+      return context.parse_path_or_authority(byte);
+    case url_parse_state::relative:
+      return context.parse_relative(byte);
+    case url_parse_state::relative_slash:
+      return context.parse_relative_slash(byte);
+    case url_parse_state::special_authority_slashes:
+      return context.parse_special_authority_slashes(byte);
+    case url_parse_state::special_authority_ignore_slashes:
+      return context.parse_special_authority_ignore_slashes(byte);
+    case url_parse_state::authority:
+      return context.parse_authority(byte);
+    case url_parse_state::host:
+    case url_parse_state::hostname:
+      return context.parse_hostname(byte);
+    case url_parse_state::port:
+      return context.parse_port(byte);
+    case url_parse_state::file:
+      return context.parse_file(byte);
+    case url_parse_state::file_slash:
+      return context.parse_file_slash(byte);
+    case url_parse_state::file_host:
+      return context.parse_file_host(byte);
+    case url_parse_state::path_start:
+      return context.parse_path_start(byte);
+    case url_parse_state::path:
+      return context.parse_path(byte);
+    case url_parse_state::cannot_be_a_base_url_path:
+      return context.parse_cannot_be_a_base_url(byte);
+    case url_parse_state::query:
+      return context.parse_query(byte);
+    case url_parse_state::fragment:
+      return context.parse_fragment(byte);
+  }
+  return url_parse_action::increment;
+}
+
+/// Runs the parser from the current state until it succeeds, it
+/// reaches the end of the input or `predicate` returns `false`
+///
+/// \param context The parser context
+/// \param predicate Tested with the context before each step
+/// \returns An error if the parser or the validation policy fails
+template <class Policy, class Predicate>
+expected<void, std::error_code> parse_while(
+    basic_url_parser_context<Policy> &context, Predicate predicate) {
+  while (predicate(std::as_const(context))) {
+    auto byte = context.is_eof() ? static_cast<char>(0) : *context.it;
+    auto action = parse_next(context, byte);
+    if (context.policy.failed()) {
+      return make_unexpected(context.policy.error());
+    }
+
+    if (!action) {
+      return make_unexpected(make_error_code(action.error()));
+    }
+
+    switch (action.value()) {
+      case url_parse_action::success:
+        return {};
+      case url_parse_action::increment:
+        break;
+      case url_parse_action::continue_:
+        continue;
+    }
+
+    if (context.is_eof()) {
+      break;
+    }
+    context.increment();
+  }
+
+  return {};
+}
+
+/// Runs the parser from the current state to the end of the input
+///
+/// \param context The parser context
+/// \returns The parsed record, or an error
+template <class Policy>
+expected<url_record, std::error_code> parse_remaining(
+    basic_url_parser_context<Policy> &context) {
+  auto result = parse_while(
+      context, [] (const basic_url_parser_context<Policy> &) { return true; });
+  if (!result) {
+    return make_unexpected(std::move(result.error()));
+  }
+  return std::move(context.url);
+}
+
+/// Once the parser reaches one of these states it can no longer
+/// fail, and it never moves back to an earlier byte or looks ahead
+/// of the current one, apart from checking for a percent-encoded
+/// byte in a cannot-be-a-base-URL path
+///
+/// \param state A parser state
+/// \returns `true` if `state` is the path start state or a later one
+inline bool is_path_or_later(url_parse_state state) noexcept {
+  switch (state) {
+    case url_parse_state::path_start:
+    case url_parse_state::path:
+    case url_parse_state::cannot_be_a_base_url_path:
+    case url_parse_state::query:
+    case url_parse_state::fragment:
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace details
 }  // namespace skyr
 
 #endif // SKYR_URL_CONTEXT_HPP
@@ -0,0 +1,41 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include "skyr/url_path.hpp"
+
+namespace skyr {
+url_path::const_iterator url_path::erase(const_iterator first, const_iterator last) {
+  auto first_index = first.index(), last_index = last.index();
+  if (first_index == last_index) {
+    return first;
+  }
+
+  // The bytes to remove, including one of the separators on either
+  // side of the removed segments, if there is one
+  auto begin_byte = (first_index == 0)? std::size_t(0) : ends_[first_index - 1];
+  auto end_byte = ends_[last_index - 1];
+  if ((first_index == 0) && (last_index < size())) {
+    ++end_byte;
+  }
+
+  auto removed = static_cast<std::uint32_t>(end_byte - begin_byte);
+  joined_.erase(begin_byte, removed);
+  ends_.erase(ends_.begin() + first_index, ends_.begin() + last_index);
+  std::for_each(ends_.begin() + first_index, ends_.end(), [removed] (auto &end) {
+    end -= removed;
+  });
+  return const_iterator(this, first_index);
+}
+
+bool operator == (const url_path &lhs, const url_path &rhs) noexcept {
+  // Only an opaque path can have a segment containing '/', so
+  // comparing the joined segments is almost always enough
+  return
+      (lhs.size() == rhs.size()) &&
+      (lhs.joined() == rhs.joined()) &&
+      std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+}  // namespace skyr
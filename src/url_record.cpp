@@ -7,6 +7,53 @@
 #include "url_schemes.hpp"
 
 namespace skyr {
+url_record::url_record(const url_record &other, const allocator_type &alloc)
+  : scheme(other.scheme, alloc)
+  , username(other.username, alloc)
+  , password(other.password, alloc)
+  , port(other.port)
+  , path(other.path, alloc)
+  , cannot_be_a_base_url(other.cannot_be_a_base_url)
+  , validation_error(other.validation_error) {
+  details::assign(host, other.host, alloc);
+  details::assign(query, other.query, alloc);
+  details::assign(fragment, other.fragment, alloc);
+}
+
+url_record &url_record::operator = (const url_record &other) {
+  if (this != &other) {
+    scheme = other.scheme;
+    username = other.username;
+    password = other.password;
+    details::assign(host, other.host, get_allocator());
+    port = other.port;
+    path = other.path;
+    details::assign(query, other.query, get_allocator());
+    details::assign(fragment, other.fragment, get_allocator());
+    cannot_be_a_base_url = other.cannot_be_a_base_url;
+    validation_error = other.validation_error;
+  }
+  return *this;
+}
+
+url_record &url_record::operator = (url_record &&other) {
+  if (get_allocator() != other.get_allocator()) {
+    return *this = static_cast<const url_record &>(other);
+  }
+
+  scheme = std::move(other.scheme);
+  username = std::move(other.username);
+  password = std::move(other.password);
+  host = std::move(other.host);
+  port = other.port;
+  path = std::move(other.path);
+  query = std::move(other.query);
+  fragment = std::move(other.fragment);
+  cannot_be_a_base_url = other.cannot_be_a_base_url;
+  validation_error = other.validation_error;
+  return *this;
+}
+
 bool url_record::is_special() const noexcept {
   return skyr::details::is_special(std::string_view(scheme));
 }
@@ -30,6 +77,7 @@ void url_record::swap(url_record &other) noexcept {
   swap(query, other.query);
   swap(fragment, other.fragment);
   swap(cannot_be_a_base_url, other.cannot_be_a_base_url);
+  swap(validation_error, other.validation_error);
 }
 
 void swap(url_record &lhs, url_record &rhs) noexcept {
@@ -0,0 +1,110 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "skyr/url_request_target.hpp"
+#include "skyr/url_parse.hpp"
+#include "skyr/url_error.hpp"
+#include "url_parser_context.hpp"
+#include "url_fast_parse.hpp"
+#include "skyr/details/char_class.hpp"
+
+namespace skyr {
+namespace {
+/// \returns `true` if `target` starts with a scheme followed by
+///          `"://"`, which distinguishes an absolute-form request
+///          target from an authority-form one such as `example.com:443`
+bool is_absolute_form(std::string_view target) noexcept {
+  if (target.empty() || !details::is_in_class(target.front(), details::char_class::alpha)) {
+    return false;
+  }
+
+  auto first = begin(target), last = end(target);
+  auto it = first + 1;
+  while ((it != last) && details::is_in_class(*it, details::char_class::scheme)) {
+    ++it;
+  }
+  return target.substr(static_cast<std::size_t>(it - first), 3).compare("://") == 0;
+}
+
+/// Parses an authority, without credentials, using the host and
+/// port states
+///
+/// \param context A parser context whose input is the authority
+/// \returns An error if the authority is not a valid host and
+///          optional port
+expected<void, std::error_code> parse_host_and_port(url_parser_context &context) {
+  if (context.is_eof()) {
+    return make_unexpected(make_error_code(url_parse_errc::empty_hostname));
+  }
+
+  context.state = url_parse_state::host;
+  auto result = details::parse_while(context, [] (const url_parser_context &context) {
+    return !details::is_path_or_later(context.state);
+  });
+  if (!result) {
+    return result;
+  }
+
+  // The host and port states stop before a '/', '?' or '#', which
+  // can't be part of a Host header or an authority-form target
+  if (!context.is_eof()) {
+    return make_unexpected(make_error_code(url_parse_errc::invalid_request_target));
+  }
+  return {};
+}
+}  // namespace
+
+expected<request_target, std::error_code> parse_request_target(
+    std::string_view target,
+    std::string_view host,
+    std::string_view scheme,
+    const url_record::allocator_type &alloc) {
+  if (target.empty()) {
+    return make_unexpected(make_error_code(url_parse_errc::invalid_request_target));
+  }
+
+  auto fast_url = details::fast_parse_request_target(scheme, host, target);
+  if (fast_url) {
+    return request_target{
+        request_target_form::origin_form, details::make_url_record(fast_url.value(), alloc)};
+  }
+
+  if (target.front() != '/') {
+    if (target.compare("*") == 0) {
+      // The asterisk form is treated as an empty path on the host
+      // given by the Host header
+    } else if (is_absolute_form(target)) {
+      auto url = parse(target, nullopt, alloc);
+      if (!url) {
+        return make_unexpected(std::move(url.error()));
+      }
+      return request_target{request_target_form::absolute_form, std::move(url.value())};
+    } else {
+      host = target;
+    }
+  }
+
+  auto context = url_parser_context(host, nullptr, nullopt, nullopt, alloc);
+  context.url.scheme = context.url.make_string(scheme);
+  auto authority = parse_host_and_port(context);
+  if (!authority) {
+    return make_unexpected(std::move(authority.error()));
+  }
+
+  if (target.front() != '/') {
+    auto form = (target.compare("*") == 0) ?
+                request_target_form::asterisk_form : request_target_form::authority_form;
+    return request_target{form, std::move(context.url)};
+  }
+
+  context.resume(target);
+  context.state = url_parse_state::path_start;
+  auto url = details::parse_remaining(context);
+  if (!url) {
+    return make_unexpected(std::move(url.error()));
+  }
+  return request_target{request_target_form::origin_form, std::move(url.value())};
+}
+}  // namespace skyr
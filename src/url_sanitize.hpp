@@ -0,0 +1,89 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_SANITIZE_HPP
+#define SKYR_URL_SANITIZE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "url_scan.hpp"
+#include "algorithms.hpp"
+
+namespace skyr {
+/// \exclude
+namespace details {
+/// \returns A pointer to the first tab or newline, or `last`
+inline const char *find_tab_or_newline(const char *first, const char *last) noexcept {
+  return find_any_of<'\t', '\n', '\r'>(first, last);
+}
+
+/// Appends the input to `output`, leaving out tabs and newlines
+///
+/// \param input The input string
+/// \param output The output string
+inline void append_without_tabs_and_newlines(std::string_view input, std::string &output) {
+  auto first = input.data(), last = first + input.size();
+  while (true) {
+    auto it = find_tab_or_newline(first, last);
+    output.append(first, it);
+    if (it == last) {
+      break;
+    }
+    first = it + 1;
+  }
+}
+
+/// The input to the parser, once it has been sanitized
+struct sanitized_input {
+  /// The input without leading and trailing C0 control or space, and
+  /// without tabs and newlines
+  std::string_view view;
+  /// `true` if C0 control or space was removed from the start
+  bool has_leading_c0_control_or_space = false;
+  /// `true` if C0 control or space was removed from the end
+  bool has_trailing_c0_control_or_space = false;
+  /// The offset of the first tab or newline in the trimmed input, or
+  /// `npos` if there are none
+  std::size_t tab_or_newline = std::string_view::npos;
+};
+
+/// Removes leading and trailing C0 control or space, then tabs and
+/// newlines, from the input
+///
+/// Trimming only looks at the bytes that are removed and the first
+/// byte that is kept at each end, so the only pass over the whole
+/// input is a vectorized search for tabs and newlines. If there are
+/// none, the result is a view into the input; otherwise the input is
+/// compacted into `storage`, whose capacity is reused.
+///
+/// \param input The input string
+/// \param storage Holds the compacted input if it had tabs or
+///        newlines
+/// \returns The sanitized input
+inline sanitized_input sanitize_input(std::string_view input, std::string &storage) {
+  auto result = sanitized_input{};
+  result.has_leading_c0_control_or_space = !remove_leading_whitespace(input);
+  result.has_trailing_c0_control_or_space = !remove_trailing_whitespace(input);
+
+  auto first = input.data(), last = first + input.size();
+  auto it = find_tab_or_newline(first, last);
+  if (it == last) {
+    result.view = input;
+    return result;
+  }
+
+  result.tab_or_newline = static_cast<std::size_t>(it - first);
+  storage.clear();
+  storage.reserve(input.size());
+  storage.append(first, it);
+  append_without_tabs_and_newlines(std::string_view(it + 1, last - (it + 1)), storage);
+  result.view = storage;
+  return result;
+}
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_SANITIZE_HPP
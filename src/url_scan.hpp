@@ -0,0 +1,148 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_SCAN_HPP
+#define SKYR_URL_SCAN_HPP
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SKYR_URL_SCAN_SSE2
+#include <emmintrin.h>
+#endif  // defined(__SSE2__) || defined(_M_X64) || ...
+
+#if defined(__AVX2__)
+#define SKYR_URL_SCAN_AVX2
+#include <immintrin.h>
+#endif  // defined(__AVX2__)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif  // defined(_MSC_VER)
+
+namespace skyr {
+/// \exclude
+namespace details {
+/// Tests whether a byte ends a run of bytes that can be copied
+/// as-is: C0 controls, space, DEL, non-ASCII bytes and any of `Bytes`
+///
+/// \tparam Bytes Additional bytes that end a run
+/// \param byte The input byte
+/// \returns `true` if the byte ends a run, `false` otherwise
+template <char... Bytes>
+constexpr bool is_run_end(char byte) noexcept {
+  return
+      (static_cast<signed char>(byte) < 0x21) ||
+      (byte == '\x7f') ||
+      ((byte == Bytes) || ...);
+}
+
+#if defined(SKYR_URL_SCAN_SSE2) || defined(SKYR_URL_SCAN_AVX2)
+inline unsigned count_trailing_zeros(unsigned value) noexcept {
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanForward(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(value));
+#endif  // defined(_MSC_VER)
+}
+#endif  // defined(SKYR_URL_SCAN_SSE2) || defined(SKYR_URL_SCAN_AVX2)
+
+/// Finds the end of a run of bytes that can be copied as-is
+///
+/// Uses AVX2 or SSE2 where the target supports them, then falls back
+/// to a byte at a time for the tail.
+///
+/// \tparam Bytes Additional bytes that end a run
+/// \param first The start of the input
+/// \param last The end of the input
+/// \returns A pointer to the first byte for which
+///          `is_run_end<Bytes...>` is `true`, or `last`
+template <char... Bytes>
+inline const char *find_run_end(const char *first, const char *last) noexcept {
+#if defined(SKYR_URL_SCAN_AVX2)
+  {
+    const auto limit = _mm256_set1_epi8(0x21);
+    const auto del = _mm256_set1_epi8(0x7f);
+    while ((last - first) >= 32) {
+      auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+      auto mask = _mm256_or_si256(
+          _mm256_cmpgt_epi8(limit, chunk), _mm256_cmpeq_epi8(chunk, del));
+      ((mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(Bytes)))), ...);
+      auto bits = static_cast<unsigned>(_mm256_movemask_epi8(mask));
+      if (bits != 0) {
+        return first + count_trailing_zeros(bits);
+      }
+      first += 32;
+    }
+  }
+#endif  // defined(SKYR_URL_SCAN_AVX2)
+
+#if defined(SKYR_URL_SCAN_SSE2)
+  {
+    const auto limit = _mm_set1_epi8(0x21);
+    const auto del = _mm_set1_epi8(0x7f);
+    while ((last - first) >= 16) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+      auto mask = _mm_or_si128(
+          _mm_cmplt_epi8(chunk, limit), _mm_cmpeq_epi8(chunk, del));
+      ((mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Bytes)))), ...);
+      auto bits = static_cast<unsigned>(_mm_movemask_epi8(mask));
+      if (bits != 0) {
+        return first + count_trailing_zeros(bits);
+      }
+      first += 16;
+    }
+  }
+#endif  // defined(SKYR_URL_SCAN_SSE2)
+
+  return std::find_if(first, last, is_run_end<Bytes...>);
+}
+
+/// Finds the first occurrence of any of `Bytes`
+///
+/// Uses AVX2 or SSE2 where the target supports them, then falls back
+/// to a byte at a time for the tail.
+///
+/// \tparam Bytes The bytes to search for
+/// \param first The start of the input
+/// \param last The end of the input
+/// \returns A pointer to the first byte that is one of `Bytes`, or
+///          `last`
+template <char... Bytes>
+inline const char *find_any_of(const char *first, const char *last) noexcept {
+#if defined(SKYR_URL_SCAN_AVX2)
+  while ((last - first) >= 32) {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+    auto mask = _mm256_setzero_si256();
+    ((mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(Bytes)))), ...);
+    auto bits = static_cast<unsigned>(_mm256_movemask_epi8(mask));
+    if (bits != 0) {
+      return first + count_trailing_zeros(bits);
+    }
+    first += 32;
+  }
+#endif  // defined(SKYR_URL_SCAN_AVX2)
+
+#if defined(SKYR_URL_SCAN_SSE2)
+  while ((last - first) >= 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    auto mask = _mm_setzero_si128();
+    ((mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Bytes)))), ...);
+    auto bits = static_cast<unsigned>(_mm_movemask_epi8(mask));
+    if (bits != 0) {
+      return first + count_trailing_zeros(bits);
+    }
+    first += 16;
+  }
+#endif  // defined(SKYR_URL_SCAN_SSE2)
+
+  return std::find_if(first, last, [] (char byte) { return ((byte == Bytes) || ...); });
+}
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_SCAN_HPP
@@ -22,7 +22,7 @@ const default_port_list &special_schemes() noexcept {
 }
 
 optional<std::uint16_t> default_port(std::string_view scheme) noexcept {
-  auto schemes = special_schemes();
+  const auto &schemes = special_schemes();
   auto first = begin(schemes), last = end(schemes);
   auto it = std::find_if(
       first, last,
@@ -37,7 +37,7 @@ optional<std::uint16_t> default_port(std::string_view scheme) noexcept {
 }
 
 bool is_special(std::string_view scheme) noexcept {
-  auto schemes = special_schemes();
+  const auto &schemes = special_schemes();
   auto first = begin(schemes), last = end(schemes);
   auto it = std::find_if(
       first, last,
@@ -5,33 +5,46 @@
 
 #include <algorithm>
 #include "skyr/url_search_parameters.hpp"
+#include "skyr/url.hpp"
 
 namespace skyr {
-url_search_parameters::url_search_parameters() {}
+url_search_parameters::url_search_parameters()
+  : url_search_parameters(allocator_type()) {}
+
+url_search_parameters::url_search_parameters(const allocator_type &alloc)
+  : parameters_(alloc) {}
 
 url_search_parameters::url_search_parameters(
-    std::string_view query) {
+    std::string_view query,
+    const allocator_type &alloc)
+  : parameters_(alloc) {
   initialize(query);
   update();
 }
 
 url_search_parameters::url_search_parameters(
     url_record &url)
-  : url_(url) {
+  : parameters_(url.get_allocator())
+  , url_(url) {
   if (url_.value().get().query) {
     initialize(url_.value().get().query.value());
   }
 }
 
+url_search_parameters::url_search_parameters(url_record &record, url *owner)
+  : url_search_parameters(record) {
+  owner_ = owner;
+}
+
 void url_search_parameters::append(
-    const string_type &name,
-    const string_type &value) {
+    std::string_view name,
+    std::string_view value) {
   parameters_.emplace_back(name, value);
   update();
 }
 
 void url_search_parameters::remove(
-    const string_type &name) {
+    std::string_view name) {
   auto first = std::begin(parameters_), last = std::end(parameters_);
   auto it = std::remove_if(
       first, last,
@@ -43,7 +56,7 @@ void url_search_parameters::remove(
 }
 
 optional<url_search_parameters::string_type> url_search_parameters::get(
-    const string_type &name) const noexcept {
+    std::string_view name) const {
   auto first = std::begin(parameters_), last = std::end(parameters_);
   auto it = std::find_if(
       first, last,
@@ -54,21 +67,21 @@ optional<url_search_parameters::string_type> url_search_parameters::get(
     return nullopt;
   }
 
-  return it->second;
+  return string_type(it->second, get_allocator());
 }
 
 std::vector<url_search_parameters::string_type> url_search_parameters::get_all(
-    const string_type &name) const {
+    std::string_view name) const {
   std::vector<string_type> result;
   for (const auto &param : parameters_) {
     if (param.first == name) {
-      result.push_back(param.second);
+      result.emplace_back(param.second, get_allocator());
     }
   }
   return result;
 }
 
-bool url_search_parameters::contains(const string_type &name) const noexcept {
+bool url_search_parameters::contains(std::string_view name) const noexcept {
   auto first = std::begin(parameters_), last = std::end(parameters_);
   auto it = std::find_if(first, last,
       [&name](const auto &parameter) -> bool {
@@ -78,8 +91,8 @@ bool url_search_parameters::contains(const string_type &name) const noexcept {
 }
 
 void url_search_parameters::set(
-    const string_type &name,
-    const string_type &value) {
+    std::string_view name,
+    std::string_view value) {
   auto first = std::begin(parameters_), last = std::end(parameters_);
   auto it = std::find_if(
       first, last,
@@ -131,7 +144,7 @@ url_search_parameters::const_iterator url_search_parameters::end() const noexcep
 }
 
 url_search_parameters::string_type url_search_parameters::to_string() const {
-  auto result = string_type{};
+  auto result = string_type(get_allocator());
 
   auto first = std::begin(parameters_), last = std::end(parameters_);
   auto it = first;
@@ -158,11 +171,11 @@ void url_search_parameters::initialize(std::string_view query) {
     auto eq_it = std::find_if(
         it, sep_it, [](auto byte) -> bool { return byte == '='; });
 
-    auto name = string_type(it, eq_it);
+    auto name = query.substr(it - first, eq_it - it);
     if (eq_it != sep_it) {
       ++eq_it;  // skip '=' symbol
     }
-    auto value = string_type(eq_it, sep_it);
+    auto value = query.substr(eq_it - first, sep_it - eq_it);
 
     parameters_.emplace_back(name, value);
 
@@ -174,10 +187,14 @@ void url_search_parameters::initialize(std::string_view query) {
 }
 
 void url_search_parameters::update() {
-  if (url_) {
+  if (owner_) {
+    // Keeps the serialized URL up to date as well as the record
+    owner_->update_query(to_string());
+  }
+  else if (url_) {
     auto query = to_string();
     if (!query.empty()) {
-      url_.value().get().query = query;
+      url_.value().get().query = std::move(query);
     } else {
       url_.value().get().query = nullopt;
     }
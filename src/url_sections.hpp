@@ -0,0 +1,95 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_SECTIONS_HPP
+#define SKYR_URL_SECTIONS_HPP
+
+#include <cstddef>
+#include "skyr/url_record.hpp"
+
+namespace skyr {
+namespace details {
+/// The parts of a serialized URL that can be serialized on their
+/// own, in the order `serialize` writes them
+enum class url_section {
+  /// The scheme and `":"`
+  scheme,
+  /// `"//"` and the credentials, host and port, if there is a host
+  /// or the scheme is `"file"`
+  authority,
+  /// The path
+  path,
+  /// `"?"` and the query, if there is a query
+  query,
+  /// `"#"` and the fragment, if there is a fragment
+  fragment,
+};
+
+/// \param url A URL record
+/// \param section A section of the serialized URL
+/// \returns The size of the section when `url` is serialized
+std::size_t section_size(const url_record &url, url_section section) noexcept;
+
+/// \param url A URL record
+/// \param first The first section
+/// \param last The last section
+/// \returns The size of the sections from `first` to `last` when
+///          `url` is serialized
+std::size_t sections_size(
+    const url_record &url, url_section first, url_section last) noexcept;
+
+/// \param url A URL record
+/// \param section A section of the serialized URL
+/// \returns The offset of the section when `url` is serialized
+std::size_t section_offset(const url_record &url, url_section section) noexcept;
+
+/// Appends one section of the serialized URL
+///
+/// \param url A URL record
+/// \param section A section of the serialized URL
+/// \param output The string to append to
+void append_section(
+    const url_record &url, url_section section, url_record::string_type &output);
+
+/// The position of a range of sections in a serialized URL
+struct url_section_range {
+  /// The first section
+  url_section first;
+  /// The last section
+  url_section last;
+  /// The offset of the first section
+  std::size_t offset;
+  /// The size of the sections
+  std::size_t size;
+};
+
+/// Finds a range of sections in the serialized URL
+///
+/// This is called before the record is changed, so that the old
+/// sections can be replaced afterwards.
+///
+/// \param url A URL record
+/// \param first The first section
+/// \param last The last section
+/// \returns The position of the sections
+url_section_range find_sections(
+    const url_record &url, url_section first, url_section last) noexcept;
+
+/// Replaces a range of sections in the serialized URL, after the
+/// record has changed
+///
+/// Only the new sections are serialized, so the cost depends on
+/// their size and not on the size of the whole URL.
+///
+/// \param url A URL record
+/// \param range The position of the old sections, from
+///        `find_sections`
+/// \param href The serialized URL
+void replace_sections(
+    const url_record &url, const url_section_range &range, url_record::string_type &href);
+}  // namespace details
+}  // namespace skyr
+
+#endif  // SKYR_URL_SECTIONS_HPP
@@ -3,56 +3,172 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#include <string>
 #include "skyr/url_serialize.hpp"
+#include "url_sections.hpp"
 
 namespace skyr {
-url_record::string_type serialize(
-    const url_record &url, bool exclude_fragment) {
-  auto output = url.scheme + ":";
+namespace {
+std::size_t digit_count(std::uint16_t value) noexcept {
+  auto count = std::size_t{1};
+  while (value >= 10) {
+    value /= 10;
+    ++count;
+  }
+  return count;
+}
 
-  if (url.host) {
-    output += "//";
-    if (url.includes_credentials()) {
-      output += url.username;
-      if (!url.password.empty()) {
-        output += ":";
-        output += url.password;
-      }
-      output += "@";
-    }
+details::url_section next(details::url_section section) noexcept {
+  return static_cast<details::url_section>(static_cast<int>(section) + 1);
+}
 
-    // TODO: serialize host
-    output += url.host.value();
+void append_sections(
+    const url_record &url,
+    details::url_section first,
+    details::url_section last,
+    url_record::string_type &output) {
+  output.reserve(output.size() + details::sections_size(url, first, last));
+  for (auto section = first; section <= last; section = next(section)) {
+    details::append_section(url, section, output);
+  }
+}
+}  // namespace
 
-    if (url.port) {
-      output += ":";
-      output += std::to_string(url.port.value());
+namespace details {
+std::size_t section_size(const url_record &url, url_section section) noexcept {
+  switch (section) {
+    case url_section::scheme:
+      return url.scheme.size() + 1;
+    case url_section::authority: {
+      if (!url.host) {
+        return (url.scheme.compare("file") == 0)? 2 : 0;
+      }
+
+      auto size = 2 + url.host.value().size();
+      if (url.includes_credentials()) {
+        size += url.username.size() + 1;
+        if (!url.password.empty()) {
+          size += url.password.size() + 1;
+        }
+      }
+      if (url.port) {
+        size += digit_count(url.port.value()) + 1;
+      }
+      return size;
     }
+    case url_section::path:
+      if (url.path.empty()) {
+        return 0;
+      }
+      return url.cannot_be_a_base_url?
+          url.path.front().size() : url.path.joined().size() + 1;
+    case url_section::query:
+      return url.query? url.query.value().size() + 1 : 0;
+    case url_section::fragment:
+      return url.fragment? url.fragment.value().size() + 1 : 0;
   }
-  else if (!url.host && (url.scheme.compare("file") == 0)) {
-    output += "//";
-  }
+  return 0;
+}
 
-  if (url.cannot_be_a_base_url) {
-    output += url.path.front();
-  }
-  else {
-    for (const auto &segment : url.path) {
-      output += "/";
-      output += segment;
-    }
+std::size_t sections_size(
+    const url_record &url, url_section first, url_section last) noexcept {
+  auto size = std::size_t{0};
+  for (auto section = first; section <= last; section = next(section)) {
+    size += section_size(url, section);
   }
+  return size;
+}
 
-  if (url.query) {
-    output += "?";
-    output += url.query.value();
+std::size_t section_offset(const url_record &url, url_section section) noexcept {
+  if (section == url_section::scheme) {
+    return 0;
   }
+  return sections_size(
+      url, url_section::scheme, static_cast<url_section>(static_cast<int>(section) - 1));
+}
+
+void append_section(
+    const url_record &url, url_section section, url_record::string_type &output) {
+  switch (section) {
+    case url_section::scheme:
+      output += url.scheme;
+      output += ":";
+      break;
+    case url_section::authority:
+      if (url.host) {
+        output += "//";
+        if (url.includes_credentials()) {
+          output += url.username;
+          if (!url.password.empty()) {
+            output += ":";
+            output += url.password;
+          }
+          output += "@";
+        }
 
-  if (!exclude_fragment && url.fragment) {
-    output += "#";
-    output += url.fragment.value();
+        // TODO: serialize host
+        output += url.host.value();
+
+        if (url.port) {
+          output += ":";
+          output += std::to_string(url.port.value());
+        }
+      }
+      else if (url.scheme.compare("file") == 0) {
+        output += "//";
+      }
+      break;
+    case url_section::path:
+      if (url.path.empty()) {
+        break;
+      }
+      if (url.cannot_be_a_base_url) {
+        output += url.path.front();
+      }
+      else {
+        output += "/";
+        output += url.path.joined();
+      }
+      break;
+    case url_section::query:
+      if (url.query) {
+        output += "?";
+        output += url.query.value();
+      }
+      break;
+    case url_section::fragment:
+      if (url.fragment) {
+        output += "#";
+        output += url.fragment.value();
+      }
+      break;
   }
+}
+
+url_section_range find_sections(
+    const url_record &url, url_section first, url_section last) noexcept {
+  return url_section_range{
+    first, last, section_offset(url, first), sections_size(url, first, last)};
+}
+
+void replace_sections(
+    const url_record &url, const url_section_range &range, url_record::string_type &href) {
+  auto sections = url.make_string();
+  append_sections(url, range.first, range.last, sections);
+  href.replace(range.offset, range.size, sections);
+}
+}  // namespace details
+
+url_record::string_type serialize(
+    const url_record &url, bool exclude_fragment) {
+  using details::url_section;
 
+  auto output = url.make_string();
+  append_sections(
+      url,
+      url_section::scheme,
+      exclude_fragment? url_section::query : url_section::fragment,
+      output);
   return output;
 }
 }  // namespace skyr
@@ -0,0 +1,269 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <string>
+#include "skyr/url_stream_parser.hpp"
+#include "skyr/percent_encode.hpp"
+#include "skyr/details/char_class.hpp"
+#include "url_parser_context.hpp"
+#include "url_sanitize.hpp"
+#include "algorithms.hpp"
+
+namespace skyr {
+namespace {
+inline bool is_tab_or_newline(char byte) noexcept {
+  return (byte == '\t') || (byte == '\r') || (byte == '\n');
+}
+
+/// The number of bytes the parser can look ahead of the current
+/// byte before it reaches the path, in
+/// `remaining_starts_with(..., "//")` and when testing for a
+/// Windows drive letter
+constexpr std::size_t lookahead = 3;
+}  // namespace
+
+struct url_stream_parser::impl {
+  impl(optional<url_record> base, const allocator_type &alloc)
+    : base(std::move(base))
+    , alloc(alloc) {
+    start();
+  }
+
+  void start() {
+    context.emplace(std::string_view(), details::base_url(base), nullopt, nullopt, alloc);
+    position = 0;
+    prefix.clear();
+    held.clear();
+    percent.clear();
+    started = false;
+    percent_pending = false;
+    validation_error = false;
+    error = nullopt;
+  }
+
+  /// Removes leading and trailing whitespace and tabs and newlines,
+  /// as the `url_parser_context` constructor does for a complete
+  /// input
+  ///
+  /// Whitespace at the end of a chunk is held back until a later
+  /// chunk shows that it is not at the end of the input.
+  std::string_view sanitize(std::string_view chunk) {
+    if (!started) {
+      validation_error |= !remove_leading_whitespace(chunk);
+      if (chunk.empty()) {
+        return chunk;
+      }
+      started = true;
+    }
+
+    auto body = chunk;
+    remove_trailing_whitespace(body);
+    auto trailing = chunk.substr(body.size());
+    auto result = body;
+
+    if (!body.empty()) {
+      auto body_last = body.data() + body.size();
+      auto has_tab_or_newline =
+          (details::find_tab_or_newline(body.data(), body_last) != body_last);
+      if (!held.empty() || has_tab_or_newline) {
+        validation_error |= has_tab_or_newline;
+        scratch.assign(held);
+        details::append_without_tabs_and_newlines(body, scratch);
+        result = scratch;
+      }
+      held.clear();
+    }
+
+    for (auto byte : trailing) {
+      if (is_tab_or_newline(byte)) {
+        validation_error = true;
+      }
+      else {
+        held.push_back(byte);
+      }
+    }
+    return result;
+  }
+
+  expected<void, url_parse_errc> parse(std::string_view input) {
+    if (details::is_path_or_later(context->state)) {
+      check_percent_encoded(input);
+      context->resume(input);
+      return parse_path_or_later(input);
+    }
+
+    // The scheme and authority states can move back to an earlier
+    // byte and look ahead of the current one, so bytes are kept
+    // until the path is reached, and a byte is only parsed once the
+    // bytes it may look at have arrived
+    prefix.append(input.data(), input.size());
+    auto view = std::string_view(prefix);
+    context->resume(view, position);
+    while (!details::is_path_or_later(context->state)) {
+      if (std::distance(context->it, end(view)) < static_cast<std::ptrdiff_t>(lookahead)) {
+        position = static_cast<std::size_t>(std::distance(begin(view), context->it));
+        return {};
+      }
+
+      auto action = details::parse_next(*context, *context->it);
+      if (!action) {
+        return make_unexpected(std::move(action.error()));
+      }
+
+      assert(action.value() != url_parse_action::success);
+      if (action.value() == url_parse_action::continue_) {
+        continue;
+      }
+      context->increment();
+    }
+
+    return parse_path_or_later(view);
+  }
+
+  /// Parses the rest of `input` in the path, query or fragment
+  /// states, which never look back
+  expected<void, url_parse_errc> parse_path_or_later(std::string_view input) {
+    while (!context->is_eof()) {
+      auto byte = *context->it;
+      auto remaining = std::distance(context->it, end(input));
+      auto action = expected<url_parse_action, url_parse_errc>{};
+      if ((context->state == url_parse_state::cannot_be_a_base_url_path) &&
+          (byte == '%') && (remaining < 3)) {
+        // The bytes that show whether this is percent encoded are in
+        // a later chunk
+        auto url_validation_error = context->url.validation_error;
+        action = details::parse_next(*context, byte);
+        context->url.validation_error = url_validation_error;
+        percent.assign(context->it + 1, end(input));
+        percent_pending = true;
+      }
+      else {
+        action = details::parse_next(*context, byte);
+      }
+
+      assert(action && (action.value() != url_parse_action::success));
+      if (action.value() == url_parse_action::continue_) {
+        continue;
+      }
+      context->increment();
+    }
+    return {};
+  }
+
+  void check_percent_encoded(std::string_view input) {
+    if (percent_pending) {
+      percent.append(input.substr(0, 2 - std::min<std::size_t>(percent.size(), 2)));
+      if (percent.size() >= 2) {
+        validation_error |=
+            !details::is_in_class(percent[0], details::char_class::hex_digit) ||
+            !details::is_in_class(percent[1], details::char_class::hex_digit);
+        percent_pending = false;
+      }
+    }
+  }
+
+  expected<url_record, url_parse_errc> finish() {
+    if (details::is_path_or_later(context->state)) {
+      context->resume(std::string_view());
+    }
+    else {
+      context->resume(prefix, position);
+    }
+
+    while (true) {
+      auto byte = context->is_eof() ? static_cast<char>(0) : *context->it;
+      auto action = details::parse_next(*context, byte);
+      if (!action) {
+        return make_unexpected(std::move(action.error()));
+      }
+
+      if (action.value() == url_parse_action::success) {
+        break;
+      }
+      if (action.value() == url_parse_action::continue_) {
+        continue;
+      }
+
+      if (context->is_eof()) {
+        break;
+      }
+      context->increment();
+    }
+
+    auto url = std::move(context->url);
+    url.validation_error |= validation_error || percent_pending || !held.empty();
+    return url;
+  }
+
+  optional<url_record> base;
+  allocator_type alloc;
+  optional<url_parser_context> context;
+
+  /// The sanitized bytes from the start of the input, until the
+  /// parser reaches the path
+  std::string prefix;
+  /// The position in `prefix` of the next byte to parse
+  std::size_t position;
+  /// A sanitized copy of the current chunk, only when tabs or
+  /// newlines had to be removed
+  std::string scratch;
+  /// Whitespace at the end of the input so far
+  std::string held;
+  /// The bytes after a `'%'` in a cannot-be-a-base-URL path
+  std::string percent;
+
+  bool started;
+  bool percent_pending;
+  bool validation_error;
+  optional<std::error_code> error;
+};
+
+url_stream_parser::url_stream_parser(
+    optional<url_record> base,
+    const allocator_type &alloc)
+  : impl_(std::make_unique<impl>(std::move(base), alloc)) {}
+
+url_stream_parser::url_stream_parser(url_stream_parser &&other) noexcept = default;
+
+url_stream_parser &url_stream_parser::operator = (url_stream_parser &&other) noexcept = default;
+
+url_stream_parser::~url_stream_parser() = default;
+
+expected<void, std::error_code> url_stream_parser::feed(std::string_view chunk) {
+  if (impl_->error) {
+    auto error = impl_->error.value();
+    return make_unexpected(std::move(error));
+  }
+
+  auto input = impl_->sanitize(chunk);
+  if (input.empty()) {
+    return {};
+  }
+
+  auto result = impl_->parse(input);
+  if (!result) {
+    auto error = make_error_code(result.error());
+    impl_->error = error;
+    return make_unexpected(std::move(error));
+  }
+  return {};
+}
+
+expected<url_record, std::error_code> url_stream_parser::finish() {
+  if (impl_->error) {
+    auto error = impl_->error.value();
+    impl_->start();
+    return make_unexpected(std::move(error));
+  }
+
+  auto result = impl_->finish();
+  impl_->start();
+  if (!result) {
+    return make_unexpected(make_error_code(result.error()));
+  }
+  return std::move(result.value());
+}
+}  // namespace skyr
@@ -0,0 +1,68 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <memory_resource>
+#include <utility>
+#include "skyr/url_view.hpp"
+#include "url_parse_impl.hpp"
+#include "url_fast_parse.hpp"
+#include "url_components_builder.hpp"
+
+namespace skyr {
+url_record url_view::to_record() const {
+  return details::make_url_record(href(), components_);
+}
+
+void url_view::swap(url_view &other) noexcept {
+  using std::swap;
+  swap(input_, other.input_);
+  swap(storage_, other.storage_);
+  swap(components_, other.components_);
+}
+
+void swap(url_view &lhs, url_view &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+expected<url_view, std::error_code> make_url_view(
+    std::string_view input,
+    const optional<url_record> &base) {
+  auto result = url_view{};
+
+  auto fast_url = details::fast_parse(input);
+  if (fast_url) {
+    if (details::serialized_size(fast_url.value()) == input.size()) {
+      result.input_ = input;
+      details::borrow_url_components(input, fast_url.value(), result.components_);
+    }
+    else {
+      details::build_url_components(fast_url.value(), result.storage_, result.components_);
+    }
+    return result;
+  }
+
+  // The record and its serialization are only needed until they have
+  // been compared with the input, so they are kept in a scratch
+  // buffer and an input in serialized form is borrowed without
+  // allocating
+  char scratch_buffer[1024];
+  std::pmr::monotonic_buffer_resource scratch(scratch_buffer, sizeof(scratch_buffer));
+  auto alloc = url_record::allocator_type(&scratch);
+
+  auto url = details::basic_parse(input, base, nullopt, nullopt, alloc);
+  if (!url) {
+    return make_unexpected(std::move(url.error()));
+  }
+
+  auto href = url_record::string_type(alloc);
+  details::build_url_components(url.value(), href, result.components_);
+  if (href == input) {
+    result.input_ = input;
+  } else {
+    result.storage_.assign(href.data(), href.size());
+  }
+  return result;
+}
+}  // namespace skyr
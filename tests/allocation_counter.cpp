@@ -0,0 +1,151 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Replaces every form of the global `operator new` and `operator
+// delete`. They are defined in their own translation unit so that
+// the compiler can't inline them into code that it sees allocating
+// with `operator new`.
+
+#include <cstdlib>
+#include <new>
+#include "allocation_counter.hpp"
+
+namespace {
+std::size_t allocations = 0;
+bool counting = false;
+
+void *allocate(std::size_t size) {
+  if (counting) {
+    ++allocations;
+  }
+  return std::malloc(size? size : 1);
+}
+
+void *allocate(std::size_t size, std::align_val_t alignment) {
+  if (counting) {
+    ++allocations;
+  }
+  auto align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+  return _aligned_malloc(size? size : 1, align);
+#else
+  // The size passed to aligned_alloc must be a multiple of the
+  // alignment
+  return std::aligned_alloc(align, ((size? size : 1) + align - 1) / align * align);
+#endif
+}
+
+void deallocate(void *p) noexcept {
+  std::free(p);
+}
+
+void deallocate(void *p, std::align_val_t) noexcept {
+#ifdef _MSC_VER
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+
+template <class... Alignment>
+void *allocate_or_throw(std::size_t size, Alignment... alignment) {
+  if (auto p = allocate(size, alignment...)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+}  // namespace
+
+namespace allocation_counter {
+void start() {
+  allocations = 0;
+  counting = true;
+}
+
+std::size_t stop() {
+  counting = false;
+  return allocations;
+}
+}  // namespace allocation_counter
+
+void *operator new(std::size_t size) {
+  return allocate_or_throw(size);
+}
+
+void *operator new[](std::size_t size) {
+  return allocate_or_throw(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return allocate(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return allocate(size, alignment);
+}
+
+void operator delete(void *p) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void *p) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  deallocate(p);
+}
+
+void operator delete(void *p, std::align_val_t alignment) noexcept {
+  deallocate(p, alignment);
+}
+
+void operator delete[](void *p, std::align_val_t alignment) noexcept {
+  deallocate(p, alignment);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t alignment) noexcept {
+  deallocate(p, alignment);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t alignment) noexcept {
+  deallocate(p, alignment);
+}
+
+void operator delete(void *p, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  deallocate(p, alignment);
+}
+
+void operator delete[](void *p, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  deallocate(p, alignment);
+}
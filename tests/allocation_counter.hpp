@@ -0,0 +1,23 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_TESTS_ALLOCATION_COUNTER_HPP
+#define SKYR_TESTS_ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+/// Counts the calls to the global allocation functions, which are
+/// replaced in allocation_counter.cpp
+namespace allocation_counter {
+/// Starts counting from zero
+void start();
+
+/// Stops counting
+///
+/// \returns The number of allocations since `start`
+std::size_t stop();
+}  // namespace allocation_counter
+
+#endif  // SKYR_TESTS_ALLOCATION_COUNTER_HPP
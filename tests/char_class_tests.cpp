@@ -0,0 +1,94 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <locale>
+#include <string_view>
+#include <skyr/details/char_class.hpp>
+#include <skyr/percent_encode.hpp>
+
+// The table replaces predicates written with `<locale>` functions and
+// linear searches, so check every byte against them
+
+namespace char_class = skyr::details::char_class;
+using skyr::details::is_in_class;
+
+namespace {
+bool is_in(char byte, std::string_view view) {
+  return std::find(begin(view), end(view), byte) != end(view);
+}
+
+template <class Test>
+void for_each_byte(Test test) {
+  for (auto i = 0; i < 256; ++i) {
+    test(static_cast<char>(i));
+  }
+}
+
+const auto &classic = std::locale::classic();
+}  // namespace
+
+static_assert(is_in_class('a', char_class::alpha));
+static_assert(!is_in_class('\xe9', char_class::alpha));
+static_assert(skyr::details::to_ascii_lower('Q') == 'q');
+static_assert(skyr::details::hex_digit_value('F') == 15);
+
+TEST(char_class_tests, alpha_digit_and_hex_digit) {
+  for_each_byte([](char byte) {
+    EXPECT_EQ(std::isalpha(byte, classic), is_in_class(byte, char_class::alpha)) << int(byte);
+    EXPECT_EQ(std::isdigit(byte, classic), is_in_class(byte, char_class::digit)) << int(byte);
+    EXPECT_EQ(std::isxdigit(byte, classic), is_in_class(byte, char_class::hex_digit)) << int(byte);
+    EXPECT_EQ(std::tolower(byte, classic), skyr::details::to_ascii_lower(byte)) << int(byte);
+  });
+}
+
+TEST(char_class_tests, hex_digit_value) {
+  for_each_byte([](char byte) {
+    if (is_in_class(byte, char_class::hex_digit)) {
+      EXPECT_EQ(std::stoi(std::string(1, byte), nullptr, 16), skyr::details::hex_digit_value(byte));
+    }
+  });
+}
+
+TEST(char_class_tests, scheme_and_url_code_points) {
+  for_each_byte([](char byte) {
+    EXPECT_EQ(
+        std::isalnum(byte, classic) || is_in(byte, "+-."),
+        is_in_class(byte, char_class::scheme)) << int(byte);
+    EXPECT_EQ(
+        std::isalnum(byte, classic) || is_in(byte, "!$&'()*+,-./:=?@_~"),
+        is_in_class(byte, char_class::url_code_point)) << int(byte);
+  });
+}
+
+TEST(char_class_tests, host_and_whitespace) {
+  for_each_byte([](char byte) {
+    EXPECT_EQ(
+        is_in(byte, std::string_view("\0\t\n\r #%/:?@[\\]", 14)),
+        is_in_class(byte, char_class::forbidden_host)) << int(byte);
+    EXPECT_EQ(
+        std::isspace(byte, classic) || is_in(byte, std::string_view("\0\x1b\x04\x12\x1f", 5)),
+        is_in_class(byte, char_class::c0_control_or_space)) << int(byte);
+  });
+}
+
+TEST(char_class_tests, percent_encode_sets) {
+  for_each_byte([](char byte) {
+    auto is_c0 = (byte <= 0x1f) || (byte > 0x7e);
+    auto is_fragment = is_c0 || is_in(byte, " \"<>`");
+    auto is_query = is_fragment || (byte == '\'');
+    auto is_path = is_fragment || is_in(byte, "#?{}");
+    auto is_userinfo = is_path || is_in(byte, "/:;=@[\\]^|");
+    EXPECT_EQ(is_c0, skyr::c0_control_set().contains(byte)) << int(byte);
+    EXPECT_EQ(is_fragment, skyr::fragment_set().contains(byte)) << int(byte);
+    EXPECT_EQ(is_query, skyr::query_set().contains(byte)) << int(byte);
+    EXPECT_EQ(is_path, skyr::path_set().contains(byte)) << int(byte);
+    EXPECT_EQ(is_userinfo, skyr::userinfo_set().contains(byte)) << int(byte);
+    EXPECT_EQ(
+        (byte < '!') || (byte > '~') || is_in(byte, "\"#<>"),
+        is_in_class(byte, char_class::query_state_percent_encode)) << int(byte);
+  });
+}
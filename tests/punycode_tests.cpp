@@ -7,6 +7,7 @@
 #include <vector>
 #include <string>
 #include "skyr/domain.hpp"
+#include "skyr/unicode.hpp"
 
 
 using param = std::pair<std::string, std::string>;
@@ -56,3 +57,30 @@ TEST_P(punycode_tests, decode_set) {
   EXPECT_EQ(expected, decoded.value())
     << input << " --> " << expected << "(" << decoded.value() << ")";
 }
+
+// RFC 3492, section 7.1, sample (L), which mixes basic and non-basic
+// code points
+TEST(punycode_tests, basic_and_non_basic_code_points) {
+  auto encoded = skyr::punycode_encode(U"3年B組金八先生");
+  ASSERT_TRUE(encoded);
+  EXPECT_EQ("xn--3B-ww4c5e180e575a65lsy2b", encoded.value());
+
+  auto decoded = skyr::punycode_decode("xn--3B-ww4c5e180e575a65lsy2b");
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ("3年B組金八先生", decoded.value());
+}
+
+TEST(punycode_tests, long_label_round_trip) {
+  auto label = std::u32string();
+  for (auto i = 0U; i < 2000U; ++i) {
+    label += static_cast<char32_t>((i % 3 == 0) ? U'a' + (i % 26) : 0x4e00 + ((i * 7919U) % 5000U));
+  }
+
+  auto encoded = skyr::punycode_encode(label);
+  ASSERT_TRUE(encoded);
+  auto decoded = skyr::punycode_decode(encoded.value());
+  ASSERT_TRUE(decoded);
+  auto expected = skyr::utf32_to_bytes(label);
+  ASSERT_TRUE(expected);
+  EXPECT_EQ(expected.value(), decoded.value());
+}
@@ -0,0 +1,99 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <string>
+#include <skyr/static_url.hpp>
+#include <skyr/url.hpp>
+
+using namespace skyr::literals;
+
+namespace {
+constexpr auto endpoint = "https://api.example.com:8443/v1/users?page=2#top"_url;
+static_assert(endpoint.scheme() == "https");
+static_assert(endpoint.protocol() == "https:");
+static_assert(endpoint.host() == "api.example.com");
+static_assert(endpoint.port().value() == 8443);
+static_assert(endpoint.pathname() == "/v1/users");
+static_assert(endpoint.query().value() == "page=2");
+static_assert(endpoint.search() == "?page=2");
+static_assert(endpoint.fragment().value() == "top");
+static_assert(endpoint.hash() == "#top");
+
+constexpr auto root = "http://example.com/"_url;
+static_assert(!root.port());
+static_assert(!root.query());
+static_assert(root.search().empty());
+static_assert(!root.fragment());
+static_assert(root.hash().empty());
+}  // namespace
+
+class static_url_tests : public ::testing::TestWithParam<std::string> {};
+
+INSTANTIATE_TEST_CASE_P(
+    static_url_tests,
+    static_url_tests,
+    ::testing::Values(
+        "http://example.com/",
+        "https://www.example.com/index.html",
+        "https://api.example.com:8443/v1/users?page=2#top",
+        "ws://localhost:8080/socket",
+        "wss://stream.example.com/socket?token=abc123",
+        "http://example.com/?",
+        "http://example.com/#",
+        "http://example.com:0/"));
+
+TEST_P(static_url_tests, same_components_as_url) {
+  auto instance = skyr::static_url(GetParam());
+  auto expected = skyr::url(GetParam());
+  EXPECT_EQ(expected.href(), instance.href());
+  EXPECT_EQ(expected.protocol(), instance.protocol());
+  EXPECT_EQ(expected.hostname(), instance.host());
+  EXPECT_EQ(expected.port(), instance.port()? std::to_string(instance.port().value()) : "");
+  EXPECT_EQ(expected.pathname(), instance.pathname());
+  EXPECT_EQ(expected.search(), instance.search());
+  EXPECT_EQ(expected.hash(), instance.hash());
+  EXPECT_EQ(expected.href(), instance.to_url().href());
+}
+
+class static_url_unsupported_tests : public ::testing::TestWithParam<std::string> {};
+
+INSTANTIATE_TEST_CASE_P(
+    static_url_tests,
+    static_url_unsupported_tests,
+    ::testing::Values(
+        // Not in serialized form
+        "http://example.com",
+        "HTTP://example.com/",
+        "http://EXAMPLE.com/",
+        "http://example.com:80/",
+        "https://example.com:0443/",
+        "http://example.com:/",
+        "http://example.com/a/../b",
+        "http://example.com/a b",
+        " http://example.com/",
+        // Not supported
+        "ftp://example.com/",
+        "http://user@example.com/",
+        "http://127.0.0.1/",
+        "http://[::1]/",
+        "http://ex\xc3\xa4mple.com/",
+        // Not valid
+        "http://example.com:65536/",
+        "http:///",
+        "example.com/"));
+
+TEST_P(static_url_unsupported_tests, throws_at_run_time) {
+  EXPECT_THROW(skyr::static_url{GetParam()}, skyr::url_parse_error);
+}
+
+TEST(static_url_tests, literal) {
+  auto instance = "https://example.com/a/b"_url;
+  EXPECT_EQ("/a/b", instance.pathname());
+  auto record = instance.to_record();
+  ASSERT_EQ(2, record.path.size());
+  EXPECT_EQ("a", record.path[0]);
+  EXPECT_EQ("b", record.path[1]);
+}
@@ -0,0 +1,45 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_TESTS_TEST_DATA_HPP
+#define SKYR_TESTS_TEST_DATA_HPP
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+/// Loads the inputs from the W3C web platform test data
+/// https://github.com/w3c/web-platform-tests/tree/master/url
+namespace test_data {
+/// An input and the base URL it is parsed against
+struct test_input {
+  std::string input;
+  std::string base;
+};
+
+inline std::ostream &operator << (std::ostream &os, const test_input &input) {
+  return os << "Input: [" << input.input << "], Base: [" << input.base << "]";
+}
+
+/// \param inputs Inputs to test before the ones in urltestdata.json
+/// \returns `inputs`, followed by each input in urltestdata.json
+inline std::vector<test_input> load_test_data(std::vector<test_input> inputs = {}) {
+  std::ifstream fs{"urltestdata.json"};
+  nlohmann::json tests;
+  fs >> tests;
+
+  for (auto &&object : tests) {
+    if (!object.is_string()) {
+      inputs.push_back(test_input{
+        object["input"].get<std::string>(), object["base"].get<std::string>()});
+    }
+  }
+  return inputs;
+}
+}  // namespace test_data
+
+#endif  // SKYR_TESTS_TEST_DATA_HPP
@@ -0,0 +1,123 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <string>
+#include <skyr/url_authority.hpp>
+#include <skyr/url_parse.hpp>
+#include <skyr/url_error.hpp>
+
+class test_parse_authority : public ::testing::TestWithParam<std::string> {};
+
+INSTANTIATE_TEST_CASE_P(url_authority_tests, test_parse_authority,
+                        testing::Values(
+                            "example.com",
+                            "example.com:8080",
+                            "EXAMPLE.com:80",
+                            "www.example.co.uk:443",
+                            "xn--nxasmq6b.example",
+                            "b\xc3\xbc\x63her.example",
+                            "ex%61mple.com",
+                            "127.0.0.1:8080",
+                            "0x7f.1",
+                            "[::1]:8443",
+                            "[2001:DB8:0:0:0:0:0:1]",
+                            "example.com:"));
+
+TEST_P(test_parse_authority, same_host_and_port_as_parse) {
+  auto expected = skyr::parse("http://" + GetParam() + "/");
+  ASSERT_TRUE(expected) << GetParam();
+
+  auto instance = skyr::parse_authority(GetParam(), "http");
+  ASSERT_TRUE(instance) << GetParam();
+  EXPECT_EQ(std::string_view(expected.value().host.value()), instance.value().host.name) << GetParam();
+  EXPECT_EQ(expected.value().port, instance.value().port) << GetParam();
+}
+
+TEST(url_authority_tests, domain) {
+  auto instance = skyr::parse_authority("example.com:8080");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::url_host_type::domain, instance.value().host.type);
+  EXPECT_EQ("example.com", instance.value().host.name);
+  EXPECT_EQ(8080, instance.value().port.value());
+}
+
+TEST(url_authority_tests, internationalized_domain) {
+  auto instance = skyr::parse_authority("B\xc3\xbc\x63her.example");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::url_host_type::domain, instance.value().host.type);
+  EXPECT_EQ("xn--bcher-kva.example", instance.value().host.name);
+  EXPECT_FALSE(instance.value().port);
+}
+
+TEST(url_authority_tests, ipv4_address) {
+  auto instance = skyr::parse_authority("192.168.257:80");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::url_host_type::ipv4_address, instance.value().host.type);
+  EXPECT_EQ("192.168.1.1", instance.value().host.name);
+  ASSERT_TRUE(instance.value().host.ipv4);
+  EXPECT_EQ(0xc0a80101, instance.value().host.ipv4.value().address());
+  EXPECT_FALSE(instance.value().host.ipv6);
+  EXPECT_EQ(80, instance.value().port.value());
+}
+
+TEST(url_authority_tests, ipv6_address) {
+  auto instance = skyr::parse_authority("[2001:db8::1]:443");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::url_host_type::ipv6_address, instance.value().host.type);
+  EXPECT_EQ("[2001:db8::1]", instance.value().host.name);
+  ASSERT_TRUE(instance.value().host.ipv6);
+  EXPECT_EQ("2001:db8::1", instance.value().host.ipv6.value().to_string());
+  EXPECT_FALSE(instance.value().host.ipv4);
+  EXPECT_EQ(443, instance.value().port.value());
+}
+
+TEST(url_authority_tests, opaque_host) {
+  auto instance = skyr::parse_authority("b\xc3\xbc\x63her:21", "foo");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::url_host_type::opaque, instance.value().host.type);
+  EXPECT_EQ("b%C3%BCcher", instance.value().host.name);
+  EXPECT_EQ(21, instance.value().port.value());
+}
+
+TEST(url_authority_tests, default_port_is_left_out_for_a_scheme) {
+  auto instance = skyr::parse_authority("example.com:443", "https");
+  ASSERT_TRUE(instance);
+  EXPECT_FALSE(instance.value().port);
+
+  instance = skyr::parse_authority("example.com:443");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(443, instance.value().port.value());
+}
+
+TEST(url_authority_tests, empty_host) {
+  for (auto input : {"", ":80"}) {
+    auto instance = skyr::parse_authority(input);
+    ASSERT_FALSE(instance) << input;
+    EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::empty_hostname), instance.error()) << input;
+  }
+}
+
+TEST(url_authority_tests, invalid_port) {
+  for (auto input : {"example.com:http", "example.com:65536", "example.com:80:80", "[::1]:x"}) {
+    auto instance = skyr::parse_authority(input);
+    ASSERT_FALSE(instance) << input;
+    EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::invalid_port), instance.error()) << input;
+  }
+}
+
+TEST(url_authority_tests, invalid_ipv6_address) {
+  for (auto input : {"[::1", "[::1]x", "[::1]x:80", "[1:2:3]"}) {
+    auto instance = skyr::parse_authority(input);
+    ASSERT_FALSE(instance) << input;
+    EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::invalid_ipv6_address), instance.error()) << input;
+  }
+}
+
+TEST(url_authority_tests, not_only_a_host_and_port) {
+  for (auto input : {"user@example.com", "example.com/path", "exa mple.com", "example.com?q"}) {
+    EXPECT_FALSE(skyr::parse_authority(input)) << input;
+  }
+}
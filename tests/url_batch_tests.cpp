@@ -0,0 +1,127 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <skyr/url_batch.hpp>
+#include <skyr/url_parse.hpp>
+#include <skyr/url_serialize.hpp>
+#include "allocation_counter.hpp"
+#include "test_data.hpp"
+
+TEST(url_batch_tests, same_components_as_parse) {
+  // Inputs that share a base are parsed as one batch
+  auto inputs = std::vector<std::string>{};
+  auto base = std::string{"about:blank"};
+  for (auto &&test : test_data::load_test_data()) {
+    if (test.base == base) {
+      inputs.push_back(test.input);
+    }
+  }
+  ASSERT_FALSE(inputs.empty());
+
+  auto base_url = skyr::parse(base);
+  ASSERT_TRUE(base_url);
+  auto batch = skyr::parse_batch(inputs, base_url.value());
+  ASSERT_EQ(inputs.size(), batch.size());
+
+  for (auto i = 0UL; i < inputs.size(); ++i) {
+    auto expected = skyr::parse(inputs[i], base_url.value());
+    const auto &instance = batch[i];
+    ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(instance)) << inputs[i];
+    if (!expected) {
+      EXPECT_EQ(expected.error(), instance.error()) << inputs[i];
+      continue;
+    }
+
+    EXPECT_EQ(std::string_view(skyr::serialize(expected.value())), instance.value().href()) << inputs[i];
+
+    auto record = instance.value().to_record();
+    EXPECT_EQ(expected.value().scheme, record.scheme) << inputs[i];
+    EXPECT_EQ(expected.value().username, record.username) << inputs[i];
+    EXPECT_EQ(expected.value().password, record.password) << inputs[i];
+    EXPECT_EQ(expected.value().host, record.host) << inputs[i];
+    EXPECT_EQ(expected.value().port, record.port) << inputs[i];
+    EXPECT_EQ(expected.value().path, record.path) << inputs[i];
+    EXPECT_EQ(expected.value().query, record.query) << inputs[i];
+    EXPECT_EQ(expected.value().fragment, record.fragment) << inputs[i];
+    EXPECT_EQ(expected.value().cannot_be_a_base_url, record.cannot_be_a_base_url) << inputs[i];
+    EXPECT_EQ(expected.value().validation_error, record.validation_error) << inputs[i];
+  }
+}
+
+TEST(url_batch_tests, results_are_in_input_order) {
+  auto inputs = std::vector<std::string_view>{
+    "https://example.com/a?q#f",
+    "not a url",
+    "mailto:user@example.com",
+  };
+  auto batch = skyr::parse_batch(inputs.begin(), inputs.end());
+  ASSERT_EQ(3, batch.size());
+  ASSERT_TRUE(batch[0]);
+  EXPECT_EQ("/a", batch[0].value().pathname());
+  EXPECT_EQ("q", batch[0].value().query().value());
+  EXPECT_EQ("f", batch[0].value().fragment().value());
+  EXPECT_FALSE(batch[1]);
+  ASSERT_TRUE(batch[2]);
+  EXPECT_TRUE(batch[2].value().cannot_be_a_base_url());
+  EXPECT_EQ("user@example.com", batch[2].value().pathname());
+}
+
+TEST(url_batch_tests, repeated_hosts_are_stored_once) {
+  auto batch = skyr::parse_batch(std::vector<std::string>{
+    "https://example.com/a",
+    "http://example.com:8080/b",
+    "https://EXAMPLE.com/c",
+    "https://example.org/d",
+  });
+  ASSERT_EQ(4, batch.size());
+  auto host = batch[0].value().host().value();
+  EXPECT_EQ(host.data(), batch[1].value().host().value().data());
+  EXPECT_EQ(host.data(), batch[2].value().host().value().data());
+  EXPECT_NE(host.data(), batch[3].value().host().value().data());
+  EXPECT_EQ(batch[0].value().scheme().data(), batch[2].value().scheme().data());
+}
+
+TEST(url_batch_tests, components_do_not_refer_to_input) {
+  auto inputs = std::vector<std::string>{"https://example.com/a?q"};
+  auto batch = skyr::parse_batch(inputs);
+  inputs[0].assign(inputs[0].size(), 'x');
+  ASSERT_TRUE(batch[0]);
+  EXPECT_EQ("https://example.com/a?q", batch[0].value().href());
+}
+
+TEST(url_batch_tests, batch_can_be_moved) {
+  auto batch = skyr::parse_batch(std::vector<std::string>{"http://example.com/path"});
+  auto pathname = batch[0].value().pathname();
+  auto moved = std::move(batch);
+  EXPECT_EQ(pathname.data(), moved[0].value().pathname().data());
+  EXPECT_EQ("/path", moved[0].value().pathname());
+}
+
+TEST(url_batch_tests, push_back) {
+  auto batch = skyr::url_batch{};
+  const auto &result = batch.push_back("http://example.com/?a=b");
+  ASSERT_TRUE(result);
+  EXPECT_EQ("a=b", result.value().query().value());
+  EXPECT_EQ(1, batch.size());
+}
+
+TEST(url_batch_tests, slow_path_allocates_from_the_arena) {
+  auto batch = skyr::url_batch{};
+  batch.reserve(3);
+  ASSERT_TRUE(batch.push_back("HTTP://example.com/a/../b?q#f"));
+
+  allocation_counter::start();
+  const auto &first = batch.push_back("HTTP://example.com/c/./d?r#g");
+  const auto &second = batch.push_back("mailto:user@example.com");
+  EXPECT_EQ(0, allocation_counter::stop());
+
+  ASSERT_TRUE(first);
+  EXPECT_EQ("http://example.com/c/d?r#g", first.value().href());
+  ASSERT_TRUE(second);
+  EXPECT_EQ("user@example.com", second.value().pathname());
+}
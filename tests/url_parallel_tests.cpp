@@ -0,0 +1,127 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <skyr/url_parallel.hpp>
+#include <skyr/url_parse.hpp>
+#include <skyr/url_serialize.hpp>
+#include "test_data.hpp"
+
+namespace {
+std::vector<std::string> load_inputs() {
+  auto inputs = std::vector<std::string>{};
+  for (auto &&test : test_data::load_test_data()) {
+    inputs.push_back(test.input);
+  }
+  return inputs;
+}
+
+void expect_same_results(
+    const std::vector<std::string_view> &inputs,
+    const skyr::parallel_url_batch &batch) {
+  ASSERT_EQ(inputs.size(), batch.size());
+  for (auto i = 0UL; i < inputs.size(); ++i) {
+    auto expected = skyr::parse(inputs[i]);
+    const auto &instance = batch[i];
+    ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(instance)) << inputs[i];
+    if (expected) {
+      EXPECT_EQ(std::string_view(skyr::serialize(expected.value())), instance.value().href()) << inputs[i];
+    }
+    else {
+      EXPECT_EQ(expected.error(), instance.error()) << inputs[i];
+    }
+  }
+}
+}  // namespace
+
+class test_parse_parallel : public ::testing::TestWithParam<std::pair<std::size_t, std::size_t>> {};
+
+INSTANTIATE_TEST_CASE_P(url_parallel_tests, test_parse_parallel,
+                        testing::Values(
+                            std::make_pair(1, 1024),
+                            std::make_pair(2, 1),
+                            std::make_pair(4, 7),
+                            std::make_pair(8, 64),
+                            std::make_pair(0, 100)));
+
+TEST_P(test_parse_parallel, results_are_in_input_order) {
+  auto corpus = load_inputs();
+  auto inputs = std::vector<std::string_view>{};
+  for (auto i = 0; i < 20; ++i) {
+    inputs.insert(inputs.end(), corpus.begin(), corpus.end());
+  }
+
+  auto options = skyr::parallel_parse_options{};
+  options.thread_count = GetParam().first;
+  options.chunk_size = GetParam().second;
+  auto batch = skyr::parse_parallel(inputs, skyr::nullopt, options);
+  if (options.thread_count != 0) {
+    EXPECT_LE(batch.thread_count(), options.thread_count);
+  }
+  expect_same_results(inputs, batch);
+}
+
+TEST(url_parallel_tests, empty_input) {
+  auto batch = skyr::parse_parallel(std::vector<std::string_view>{});
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(batch.begin(), batch.end());
+}
+
+TEST(url_parallel_tests, more_threads_than_chunks) {
+  auto options = skyr::parallel_parse_options{};
+  options.thread_count = 16;
+  auto batch = skyr::parse_parallel(
+      std::vector<std::string_view>{"http://example.com/", "https://example.org/"},
+      skyr::nullopt, options);
+  EXPECT_EQ(1, batch.thread_count());
+  ASSERT_EQ(2, batch.size());
+  EXPECT_EQ("example.org", batch[1].value().host().value());
+}
+
+TEST(url_parallel_tests, base_url) {
+  auto base = skyr::parse("http://example.com/a/b");
+  ASSERT_TRUE(base);
+  auto batch = skyr::parse_parallel(
+      std::vector<std::string_view>{"c", "../d"}, base.value());
+  ASSERT_EQ(2, batch.size());
+  EXPECT_EQ("http://example.com/a/c", batch[0].value().href());
+  EXPECT_EQ("http://example.com/d", batch[1].value().href());
+}
+
+TEST(url_parallel_tests, lines) {
+  auto options = skyr::parallel_parse_options{};
+  options.thread_count = 2;
+  options.chunk_size = 1;
+  auto batch = skyr::parse_parallel_lines(
+      "http://example.com/\r\nnot a url\n\nhttps://example.org/?q\n", skyr::nullopt, options);
+  ASSERT_EQ(4, batch.size());
+  EXPECT_EQ("http://example.com/", batch[0].value().href());
+  EXPECT_FALSE(batch[1]);
+  EXPECT_FALSE(batch[2]);
+  EXPECT_EQ("q", batch[3].value().query().value());
+}
+
+TEST(url_parallel_tests, iterate_in_order) {
+  auto inputs = std::vector<std::string_view>{};
+  auto hosts = std::vector<std::string>{};
+  for (auto i = 0; i < 1000; ++i) {
+    hosts.push_back("http://host" + std::to_string(i) + ".example.com/");
+  }
+  inputs.assign(hosts.begin(), hosts.end());
+
+  auto options = skyr::parallel_parse_options{};
+  options.thread_count = 4;
+  options.chunk_size = 3;
+  auto batch = skyr::parse_parallel(inputs, skyr::nullopt, options);
+
+  auto i = 0;
+  for (const auto &result : batch) {
+    ASSERT_TRUE(result);
+    EXPECT_EQ(hosts[i++], result.value().href());
+  }
+  EXPECT_EQ(1000, i);
+}
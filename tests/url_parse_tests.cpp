@@ -6,6 +6,8 @@
 #include <fstream>
 #include <gtest/gtest.h>
 #include <skyr/url_parse.hpp>
+#include <skyr/url_error.hpp>
+#include "test_data.hpp"
 
 // http://formvalidation.io/validators/uri/
 
@@ -34,3 +36,197 @@ TEST_P(test_valid_urls, parse) {
   auto result = skyr::parse(input);
   EXPECT_TRUE(result);
 }
+
+TEST_P(test_valid_urls, is_valid_url) {
+  EXPECT_TRUE(skyr::is_valid_url(GetParam()));
+}
+
+// The validation-only path agrees with `parse` on the web platform
+// test data
+TEST(url_parse_tests, is_valid_url_agrees_with_parse) {
+  auto count = 0;
+  for (auto &&test : test_data::load_test_data()) {
+    const auto &input = test.input;
+    auto base = skyr::optional<skyr::url_record>{};
+    auto base_url = skyr::parse(test.base);
+    if (base_url) {
+      base = std::move(base_url.value());
+    }
+
+    EXPECT_EQ(static_cast<bool>(skyr::parse(input, base)), skyr::is_valid_url(input, base))
+        << test;
+    EXPECT_EQ(static_cast<bool>(skyr::parse(input)), skyr::is_valid_url(input))
+        << "Input: [" << input << "]";
+    ++count;
+  }
+  EXPECT_GT(count, 0);
+}
+
+TEST(url_parse_tests, is_valid_url_rejects_invalid_hosts) {
+  EXPECT_FALSE(skyr::is_valid_url("http://exa mple.com/"));
+  EXPECT_FALSE(skyr::is_valid_url("http://[::1.2.3.]/"));
+  EXPECT_FALSE(skyr::is_valid_url("http://256.256.256.256/a/b?q#f"));
+  EXPECT_FALSE(skyr::is_valid_url("https://x n--/"));
+  EXPECT_FALSE(skyr::is_valid_url("http://example.com:99999/path"));
+  EXPECT_FALSE(skyr::is_valid_url("http://example.com:port/path"));
+  EXPECT_FALSE(skyr::is_valid_url("relative/path"));
+  EXPECT_TRUE(skyr::is_valid_url("http://[::1]:8080/a b?c d#e f"));
+}
+
+// Parsing up to a component gives the same components as a full
+// parse on the web platform test data
+TEST(url_parse_tests, parse_until_agrees_with_parse) {
+  auto count = 0;
+  for (auto &&test : test_data::load_test_data()) {
+    const auto &input = test.input;
+    auto base = skyr::optional<skyr::url_record>{};
+    auto base_url = skyr::parse(test.base);
+    if (base_url) {
+      base = std::move(base_url.value());
+    }
+
+    auto expected = skyr::parse(input, base);
+    if (!expected) {
+      continue;
+    }
+
+    auto scheme = skyr::parse_until(input, skyr::url_component::scheme, base);
+    ASSERT_TRUE(scheme) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().scheme, scheme.value().scheme) << "Input: [" << input << "]";
+
+    auto host = skyr::parse_until(input, skyr::url_component::host, base);
+    ASSERT_TRUE(host) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().scheme, host.value().scheme) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().username, host.value().username) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().password, host.value().password) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().host, host.value().host) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().port, host.value().port) << "Input: [" << input << "]";
+
+    auto query = skyr::parse_until(input, skyr::url_component::query, base);
+    ASSERT_TRUE(query) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().path, query.value().path) << "Input: [" << input << "]";
+    EXPECT_EQ(expected.value().query, query.value().query) << "Input: [" << input << "]";
+    ++count;
+  }
+  EXPECT_GT(count, 0);
+}
+
+TEST(url_parse_tests, parse_until_host_skips_the_rest) {
+  auto instance = skyr::parse_until(
+      "https://user@EXAMPLE.com:8080/a/long/path?q=1#fragment", skyr::url_component::host);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("https", instance.value().scheme);
+  EXPECT_EQ("user", instance.value().username);
+  EXPECT_EQ("example.com", instance.value().host.value());
+  EXPECT_EQ(8080, instance.value().port.value());
+  EXPECT_TRUE(instance.value().path.empty());
+  EXPECT_FALSE(instance.value().query);
+  EXPECT_FALSE(instance.value().fragment);
+}
+
+TEST(url_parse_tests, parse_until_host_of_a_common_url) {
+  auto instance = skyr::parse_until(
+      "https://www.example.com:443/path/to/resource?query=1&b=2#frag", skyr::url_component::port);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("https", instance.value().scheme);
+  EXPECT_EQ("www.example.com", instance.value().host.value());
+  EXPECT_FALSE(instance.value().port);
+  EXPECT_TRUE(instance.value().path.empty());
+  EXPECT_FALSE(instance.value().query);
+  EXPECT_FALSE(instance.value().fragment);
+
+  instance = skyr::parse_until(
+      "http://api.service.internal:8080/v1/users/12345?page=2", skyr::url_component::path);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(8080, instance.value().port.value());
+  ASSERT_EQ(3, instance.value().path.size());
+  EXPECT_EQ("12345", instance.value().path[2]);
+  EXPECT_FALSE(instance.value().query);
+}
+
+TEST(url_parse_tests, parse_until_scheme) {
+  auto instance = skyr::parse_until("http://exa mple.com/", skyr::url_component::scheme);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("http", instance.value().scheme);
+  EXPECT_FALSE(instance.value().host);
+}
+
+TEST(url_parse_tests, parse_until_scheme_with_base) {
+  auto base = skyr::parse("http://example.org/foo/bar");
+  ASSERT_TRUE(base);
+  auto instance = skyr::parse_until("pix/submit.gif", skyr::url_component::scheme, base.value());
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("http", instance.value().scheme);
+  EXPECT_TRUE(instance.value().path.empty());
+
+  base = skyr::parse("file:///C:/Windows");
+  ASSERT_TRUE(base);
+  instance = skyr::parse_until("/a", skyr::url_component::scheme, base.value());
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("file", instance.value().scheme);
+}
+
+TEST(url_parse_tests, parse_until_path) {
+  auto instance = skyr::parse_until("http://example.com/a/b?q=1#f", skyr::url_component::path);
+  ASSERT_TRUE(instance);
+  ASSERT_EQ(2, instance.value().path.size());
+  EXPECT_EQ("b", instance.value().path[1]);
+  EXPECT_FALSE(instance.value().query);
+}
+
+TEST(url_parse_tests, parse_until_reports_authority_errors) {
+  EXPECT_FALSE(skyr::parse_until("http://exa mple.com/", skyr::url_component::host));
+  EXPECT_FALSE(skyr::parse_until("http://example.com:99999/", skyr::url_component::host));
+  EXPECT_FALSE(skyr::parse_until("relative/path", skyr::url_component::scheme));
+}
+
+TEST(url_parse_tests, parse_rejects_long_input) {
+  auto options = skyr::url_parse_options{};
+  options.max_input_length = 19;
+  auto instance = skyr::parse("http://example.com/", options);
+  ASSERT_TRUE(instance);
+
+  instance = skyr::parse("http://example.com/a", options);
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::url_parse_errc::input_too_long, instance.error());
+}
+
+TEST(url_parse_tests, parse_many_at_signs) {
+  auto input = std::string("http://");
+  for (auto i = 0; i < 1000; ++i) {
+    input += "a:b@";
+  }
+  input += "example.com/";
+
+  auto instance = skyr::parse(input);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("example.com", instance.value().host.value());
+  EXPECT_EQ("a", instance.value().username);
+  EXPECT_EQ(1 + 999 * 8, instance.value().password.size());
+  EXPECT_EQ("b%40a%3Ab%40", instance.value().password.substr(0, 12));
+}
+
+TEST(url_parse_tests, parse_removes_tabs_and_newlines_anywhere) {
+  // Put tabs and newlines on either side of each 16 and 32 byte
+  // boundary of a long input
+  auto path = std::string("/");
+  for (auto i = 0; i < 100; ++i) {
+    path += static_cast<char>('a' + (i % 26));
+  }
+  auto expected = skyr::parse("http://example.com" + path);
+  ASSERT_TRUE(expected);
+
+  for (auto offset = 1UL; offset < path.size(); ++offset) {
+    for (auto separator : {"\t", "\n", "\r\n", "\t\t\t"}) {
+      auto input = "http://example.com" + path;
+      input.insert(18 + offset, separator);
+      auto policy = skyr::collect_validation_errors{};
+      auto instance = skyr::parse("  " + input + " \r\n", policy);
+      ASSERT_TRUE(instance) << offset;
+      EXPECT_EQ(expected.value().path, instance.value().path) << offset;
+      ASSERT_EQ(3, policy.errors().size()) << offset;
+      EXPECT_EQ(skyr::url_validation_errc::tab_or_newline, policy.errors()[1].code) << offset;
+      EXPECT_EQ(18 + offset, policy.errors()[1].offset) << offset;
+    }
+  }
+}
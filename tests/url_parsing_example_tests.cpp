@@ -149,3 +149,26 @@ TEST(url_parsing_example_tests, test_protocol_non_special_to_special) {
   ASSERT_TRUE(instance);
   EXPECT_EQ("non-special://example.com/", skyr::serialize(instance.value()));
 }
+
+TEST(url_parsing_example_tests, url_long_path_with_encoded_bytes) {
+  auto segment = std::string(40, 'a');
+  auto instance = skyr::parse("non-special://host/" + segment + " " + segment + "{/" + segment);
+  ASSERT_TRUE(instance);
+  ASSERT_EQ(2, instance.value().path.size());
+  EXPECT_EQ(segment + "%20" + segment + "%7B", std::string_view(instance.value().path[0]));
+  EXPECT_EQ(segment, std::string_view(instance.value().path[1]));
+}
+
+TEST(url_parsing_example_tests, url_long_query_with_encoded_bytes) {
+  auto value = std::string(40, 'q');
+  auto instance = skyr::parse("https://EXAMPLE.com/?" + value + " '" + value + "\x7f" + value);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(value + "%20%27" + value + "%7F" + value, std::string_view(instance.value().query.value()));
+}
+
+TEST(url_parsing_example_tests, url_long_fragment_with_encoded_bytes) {
+  auto value = std::string(40, 'f');
+  auto instance = skyr::parse("https://EXAMPLE.com/#" + value + "`" + value + "\xc3\xa9" + value);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(value + "%60" + value + "%C3%A9" + value, std::string_view(instance.value().fragment.value()));
+}
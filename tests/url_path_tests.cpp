@@ -0,0 +1,110 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <skyr/url_path.hpp>
+#include <skyr/url_parse.hpp>
+
+namespace {
+std::vector<std::string> segments(const skyr::url_path &path) {
+  return std::vector<std::string>(path.begin(), path.end());
+}
+}  // namespace
+
+TEST(url_path_tests, empty_path) {
+  auto path = skyr::url_path();
+  EXPECT_TRUE(path.empty());
+  EXPECT_EQ(0, path.size());
+  EXPECT_EQ(path.begin(), path.end());
+  EXPECT_EQ("", path.joined());
+}
+
+TEST(url_path_tests, one_empty_segment_is_not_an_empty_path) {
+  auto path = skyr::url_path();
+  path.emplace_back();
+  EXPECT_FALSE(path.empty());
+  EXPECT_EQ(1, path.size());
+  EXPECT_EQ("", path[0]);
+  EXPECT_EQ("", path.joined());
+  EXPECT_NE(skyr::url_path(), path);
+}
+
+TEST(url_path_tests, push_back) {
+  auto path = skyr::url_path();
+  path.push_back("a");
+  path.push_back("");
+  path.push_back("bc");
+  EXPECT_EQ((std::vector<std::string>{"a", "", "bc"}), segments(path));
+  EXPECT_EQ("a//bc", path.joined());
+  EXPECT_EQ("a", path.front());
+  EXPECT_EQ("bc", path.back());
+}
+
+TEST(url_path_tests, pop_back) {
+  auto path = skyr::url_path{"a", "b", "c"};
+  path.pop_back();
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), segments(path));
+  EXPECT_EQ("a/b", path.joined());
+  path.pop_back();
+  path.pop_back();
+  EXPECT_TRUE(path.empty());
+  EXPECT_EQ("", path.joined());
+}
+
+TEST(url_path_tests, append_to_back) {
+  auto path = skyr::url_path{"a", "b"};
+  path.append_to_back("cd");
+  EXPECT_EQ((std::vector<std::string>{"a", "bcd"}), segments(path));
+}
+
+TEST(url_path_tests, erase_from_the_front) {
+  auto path = skyr::url_path{"", "", "a", "b"};
+  auto it = path.erase(path.begin(), path.begin() + 2);
+  EXPECT_EQ(path.begin(), it);
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), segments(path));
+  EXPECT_EQ("a/b", path.joined());
+}
+
+TEST(url_path_tests, erase_from_the_middle) {
+  auto path = skyr::url_path{"a", "b", "c", "d"};
+  path.erase(path.begin() + 1, path.begin() + 3);
+  EXPECT_EQ((std::vector<std::string>{"a", "d"}), segments(path));
+  EXPECT_EQ("a/d", path.joined());
+}
+
+TEST(url_path_tests, erase_everything) {
+  auto path = skyr::url_path{"a", "b"};
+  path.erase(path.begin(), path.end());
+  EXPECT_TRUE(path.empty());
+  EXPECT_EQ("", path.joined());
+}
+
+TEST(url_path_tests, segments_containing_a_solidus_are_compared_by_segment) {
+  auto opaque = skyr::url_path{"a/b", "c"};
+  auto hierarchical = skyr::url_path{"a", "b/c"};
+  EXPECT_EQ(opaque.joined(), hierarchical.joined());
+  EXPECT_NE(opaque, hierarchical);
+}
+
+TEST(url_path_tests, copy_with_allocator) {
+  auto buffer = std::pmr::monotonic_buffer_resource();
+  auto path = skyr::url_path{"a", "b"};
+  auto copy = skyr::url_path(path, &buffer);
+  EXPECT_EQ(path, copy);
+  EXPECT_EQ(&buffer, copy.get_allocator().resource());
+}
+
+TEST(url_path_tests, dot_segments_are_removed_from_a_long_path) {
+  auto instance = skyr::parse("http://example.com/a/b/c/./d/../../e/f/g/h/i/j/../k");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(
+      (std::vector<std::string>{"a", "b", "e", "f", "g", "h", "i", "k"}),
+      segments(instance.value().path));
+  EXPECT_EQ("a/b/e/f/g/h/i/k", instance.value().path.joined());
+}
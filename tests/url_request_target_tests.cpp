@@ -0,0 +1,180 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <string>
+#include <skyr/url_request_target.hpp>
+#include <skyr/url_parse.hpp>
+#include <skyr/url_serialize.hpp>
+#include <skyr/url_error.hpp>
+
+namespace {
+struct test_input {
+  std::string target;
+  std::string host;
+  std::string scheme;
+};
+
+std::ostream &operator << (std::ostream &os, const test_input &input) {
+  return os << "Target: [" << input.target << "], Host: ["
+            << input.host << "], Scheme: [" << input.scheme << "]";
+}
+}  // namespace
+
+class test_origin_form : public ::testing::TestWithParam<test_input> {};
+
+INSTANTIATE_TEST_CASE_P(url_request_target_tests, test_origin_form,
+                        testing::Values(
+                            test_input{"/", "example.com", "http"},
+                            test_input{"/path/to/resource?q=1&r=2", "example.com", "http"},
+                            test_input{"/a b/../c?d e", "example.com:8080", "http"},
+                            test_input{"/%7Euser/./x?", "EXAMPLE.com:80", "http"},
+                            test_input{"/api?x=\xce\xbb", "[::1]:8443", "https"},
+                            test_input{"/a/b#c", "127.0.0.1", "http"},
+                            test_input{"//a//b\\c", "xn--nxasmq6b.example", "https"},
+                            test_input{"/x", "b\xc3\xbc\x63her.example", "ws"},
+                            test_input{"/x", "example.com:443", "https"}));
+
+TEST_P(test_origin_form, same_as_parse) {
+  auto expected = skyr::parse(
+      GetParam().scheme + "://" + GetParam().host + GetParam().target);
+  ASSERT_TRUE(expected) << GetParam();
+
+  auto instance = skyr::parse_request_target(
+      GetParam().target, GetParam().host, GetParam().scheme);
+  ASSERT_TRUE(instance) << GetParam();
+  EXPECT_EQ(skyr::request_target_form::origin_form, instance.value().form);
+
+  auto &url = instance.value().url;
+  EXPECT_EQ(expected.value().scheme, url.scheme) << GetParam();
+  EXPECT_EQ(expected.value().host, url.host) << GetParam();
+  EXPECT_EQ(expected.value().port, url.port) << GetParam();
+  EXPECT_EQ(expected.value().path, url.path) << GetParam();
+  EXPECT_EQ(expected.value().query, url.query) << GetParam();
+  EXPECT_EQ(expected.value().fragment, url.fragment) << GetParam();
+  EXPECT_EQ(skyr::serialize(expected.value()), skyr::serialize(url)) << GetParam();
+}
+
+TEST(url_request_target_tests, origin_form) {
+  auto instance = skyr::parse_request_target("/search?q=url", "example.com:8080");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::request_target_form::origin_form, instance.value().form);
+  EXPECT_EQ("http", instance.value().url.scheme);
+  EXPECT_EQ("example.com", instance.value().url.host.value());
+  EXPECT_EQ(8080, instance.value().url.port.value());
+  ASSERT_EQ(1, instance.value().url.path.size());
+  EXPECT_EQ("search", instance.value().url.path[0]);
+  EXPECT_EQ("q=url", instance.value().url.query.value());
+}
+
+TEST(url_request_target_tests, absolute_form_ignores_the_host_header) {
+  auto instance = skyr::parse_request_target(
+      "http://example.org:81/x?y", "example.com", "https");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::request_target_form::absolute_form, instance.value().form);
+  EXPECT_EQ("http://example.org:81/x?y", skyr::serialize(instance.value().url));
+}
+
+TEST(url_request_target_tests, authority_form) {
+  auto instance = skyr::parse_request_target("example.com:443", "ignored.example", "https");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::request_target_form::authority_form, instance.value().form);
+  EXPECT_EQ("https", instance.value().url.scheme);
+  EXPECT_EQ("example.com", instance.value().url.host.value());
+  EXPECT_FALSE(instance.value().url.port);
+  EXPECT_TRUE(instance.value().url.path.empty());
+
+  instance = skyr::parse_request_target("[2001:db8::1]:8443", "", "https");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::request_target_form::authority_form, instance.value().form);
+  EXPECT_EQ("[2001:db8::1]", instance.value().url.host.value());
+  EXPECT_EQ(8443, instance.value().url.port.value());
+}
+
+TEST(url_request_target_tests, asterisk_form) {
+  auto instance = skyr::parse_request_target("*", "example.com:8080");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ(skyr::request_target_form::asterisk_form, instance.value().form);
+  EXPECT_EQ("example.com", instance.value().url.host.value());
+  EXPECT_EQ(8080, instance.value().url.port.value());
+  EXPECT_TRUE(instance.value().url.path.empty());
+  EXPECT_FALSE(instance.value().url.query);
+}
+
+TEST(url_request_target_tests, empty_target_is_invalid) {
+  auto instance = skyr::parse_request_target("", "example.com");
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::invalid_request_target), instance.error());
+}
+
+TEST(url_request_target_tests, empty_host_is_invalid) {
+  auto instance = skyr::parse_request_target("/", "");
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::empty_hostname), instance.error());
+
+  instance = skyr::parse_request_target("/", ":80");
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::empty_hostname), instance.error());
+}
+
+TEST(url_request_target_tests, host_header_must_only_be_an_authority) {
+  for (auto host : {"example.com/path", "example.com?q", "example.com:80#f", "user@example.com"}) {
+    EXPECT_FALSE(skyr::parse_request_target("/", host)) << host;
+  }
+}
+
+TEST(url_request_target_tests, invalid_port) {
+  auto instance = skyr::parse_request_target("/", "example.com:http");
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::invalid_port), instance.error());
+
+  instance = skyr::parse_request_target("example.com:65536", "");
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::invalid_port), instance.error());
+}
+
+TEST(url_request_target_tests, authority_form_must_only_be_an_authority) {
+  auto instance = skyr::parse_request_target("example.com:443/x", "");
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::make_error_code(skyr::url_parse_errc::invalid_request_target), instance.error());
+}
+
+TEST(url_request_target_tests, host_header_with_trailing_delimiter_is_invalid) {
+  for (auto host : {"example.com/", "example.com?", "example.com#", "example.com:80/"}) {
+    auto instance = skyr::parse_request_target("/a", host);
+    ASSERT_FALSE(instance) << host;
+    EXPECT_EQ(
+        skyr::make_error_code(skyr::url_parse_errc::invalid_request_target),
+        instance.error()) << host;
+  }
+}
+
+TEST(url_request_target_tests, authority_form_with_trailing_delimiter_is_invalid) {
+  for (auto target : {"example.com/", "example.com?", "example.com#", "example.com:443/"}) {
+    auto instance = skyr::parse_request_target(target, "");
+    ASSERT_FALSE(instance) << target;
+    EXPECT_EQ(
+        skyr::make_error_code(skyr::url_parse_errc::invalid_request_target),
+        instance.error()) << target;
+  }
+}
+
+TEST(url_request_target_tests, tabs_in_the_target_are_percent_encoded) {
+  auto instance = skyr::parse_request_target("/a\t/b", "example.com");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("http://example.com/a%09/b", skyr::serialize(instance.value().url));
+
+  auto url = skyr::parse("http://example.com/a\t/b");
+  ASSERT_TRUE(url);
+  EXPECT_EQ("http://example.com/a/b", skyr::serialize(url.value()));
+}
+
+TEST(url_request_target_tests, host_header_is_trimmed) {
+  auto instance = skyr::parse_request_target("/", " example.com ");
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("example.com", instance.value().url.host.value());
+
+  EXPECT_FALSE(skyr::parse("http:// example.com /"));
+}
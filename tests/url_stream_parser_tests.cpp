@@ -0,0 +1,210 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <skyr/url_stream_parser.hpp>
+#include <skyr/url_parse.hpp>
+#include "test_data.hpp"
+
+namespace {
+using test_data::test_input;
+
+std::vector<test_input> load_test_data() {
+  return test_data::load_test_data({
+    {"  http://example.com/a b?c d#e f  ", "about:blank"},
+    {"\t h\tt\ntp://exa\rmple.com/\t  \t", "about:blank"},
+    {"file:///C|/dir/../file", "about:blank"},
+    {"mailto:user%4@example.com%", "about:blank"},
+    {"mailto:a%41b%4", "about:blank"},
+    {"javascript:%zz%", "about:blank"},
+    {"../a/./b", "http://example.com/x/y/z"},
+    {"C|/file", "file:///D:/dir/"},
+  });
+}
+
+std::vector<std::string_view> split(std::string_view input, std::mt19937 &generator) {
+  auto chunks = std::vector<std::string_view>{};
+  while (!input.empty()) {
+    auto distribution = std::uniform_int_distribution<std::size_t>(0, input.size());
+    auto chunk = input.substr(0, distribution(generator));
+    chunks.push_back(chunk);
+    input.remove_prefix(chunk.size());
+  }
+  return chunks;
+}
+
+skyr::expected<skyr::url_record, std::error_code> stream_parse(
+    const std::vector<std::string_view> &chunks,
+    const skyr::optional<skyr::url_record> &base) {
+  auto parser = skyr::url_stream_parser(base);
+  for (auto chunk : chunks) {
+    auto result = parser.feed(chunk);
+    if (!result) {
+      // Once an error is found, it doesn't change
+      EXPECT_EQ(result.error(), parser.feed("x").error());
+      break;
+    }
+  }
+  return parser.finish();
+}
+
+void expect_same_result(
+    const skyr::expected<skyr::url_record, std::error_code> &expected,
+    const skyr::expected<skyr::url_record, std::error_code> &instance,
+    const test_input &input) {
+  ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(instance)) << input;
+  if (!expected) {
+    EXPECT_EQ(expected.error(), instance.error()) << input;
+    return;
+  }
+
+  EXPECT_EQ(expected.value().scheme, instance.value().scheme) << input;
+  EXPECT_EQ(expected.value().username, instance.value().username) << input;
+  EXPECT_EQ(expected.value().password, instance.value().password) << input;
+  EXPECT_EQ(expected.value().host, instance.value().host) << input;
+  EXPECT_EQ(expected.value().port, instance.value().port) << input;
+  EXPECT_EQ(expected.value().path, instance.value().path) << input;
+  EXPECT_EQ(expected.value().query, instance.value().query) << input;
+  EXPECT_EQ(expected.value().fragment, instance.value().fragment) << input;
+  EXPECT_EQ(expected.value().cannot_be_a_base_url, instance.value().cannot_be_a_base_url) << input;
+  EXPECT_EQ(expected.value().validation_error, instance.value().validation_error) << input;
+}
+}  // namespace
+
+class test_url_stream_parser : public ::testing::TestWithParam<test_input> {
+ protected:
+  void SetUp() override {
+    auto base_url = skyr::parse(GetParam().base);
+    if (base_url) {
+      base = base_url.value();
+    }
+    expected = skyr::parse(GetParam().input, base);
+  }
+
+  skyr::optional<skyr::url_record> base;
+  skyr::expected<skyr::url_record, std::error_code> expected;
+};
+
+INSTANTIATE_TEST_CASE_P(url_stream_parser_tests, test_url_stream_parser,
+                        testing::ValuesIn(load_test_data()));
+
+TEST_P(test_url_stream_parser, one_chunk) {
+  auto input = std::string_view(GetParam().input);
+  expect_same_result(expected, stream_parse({input}, base), GetParam());
+}
+
+TEST_P(test_url_stream_parser, one_byte_chunks) {
+  auto input = std::string_view(GetParam().input);
+  auto chunks = std::vector<std::string_view>{};
+  for (auto i = 0UL; i < input.size(); ++i) {
+    chunks.push_back(input.substr(i, 1));
+  }
+  expect_same_result(expected, stream_parse(chunks, base), GetParam());
+}
+
+TEST_P(test_url_stream_parser, random_chunks) {
+  auto generator = std::mt19937(static_cast<std::mt19937::result_type>(
+      std::hash<std::string>()(GetParam().input)));
+  for (auto i = 0; i < 20; ++i) {
+    auto chunks = split(GetParam().input, generator);
+    expect_same_result(expected, stream_parse(chunks, base), GetParam());
+  }
+}
+
+TEST_P(test_url_stream_parser, segments) {
+  auto generator = std::mt19937(static_cast<std::mt19937::result_type>(
+      std::hash<std::string>()(GetParam().input)));
+  for (auto i = 0; i < 20; ++i) {
+    auto segments = split(GetParam().input, generator);
+    expect_same_result(expected, skyr::parse_segments(segments, base), GetParam());
+  }
+}
+
+TEST(url_stream_parser_tests, chunks_need_not_outlive_feed) {
+  auto parser = skyr::url_stream_parser{};
+  for (auto chunk : {"https://exam", "ple.com/a/", "b?q=1", "#frag"}) {
+    auto buffer = std::string(chunk);
+    ASSERT_TRUE(parser.feed(buffer));
+    buffer.assign(buffer.size(), 'x');
+  }
+  auto instance = parser.finish();
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("example.com", instance.value().host.value());
+  EXPECT_EQ("q=1", instance.value().query.value());
+  EXPECT_EQ("frag", instance.value().fragment.value());
+}
+
+TEST(url_stream_parser_tests, error_is_reported_early) {
+  auto parser = skyr::url_stream_parser{};
+  ASSERT_TRUE(parser.feed("http://exa"));
+  auto result = parser.feed("mple.com:port/abc");
+  ASSERT_FALSE(result);
+  EXPECT_FALSE(parser.feed("a/b/c"));
+  EXPECT_EQ(result.error(), parser.finish().error());
+}
+
+TEST(url_stream_parser_tests, parser_can_be_reused) {
+  auto parser = skyr::url_stream_parser{};
+  ASSERT_FALSE(parser.feed("http://exa mple.com/abc"));
+  EXPECT_FALSE(parser.finish());
+
+  ASSERT_TRUE(parser.feed("http://example.org/"));
+  auto instance = parser.finish();
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("example.org", instance.value().host.value());
+}
+
+TEST(url_stream_parser_tests, base_url) {
+  auto base = skyr::parse("http://example.com/a/b");
+  ASSERT_TRUE(base);
+  auto parser = skyr::url_stream_parser(base.value());
+  ASSERT_TRUE(parser.feed("../"));
+  ASSERT_TRUE(parser.feed("c"));
+  auto instance = parser.finish();
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("example.com", instance.value().host.value());
+  ASSERT_EQ(1, instance.value().path.size());
+  EXPECT_EQ("c", instance.value().path[0]);
+}
+
+TEST(url_stream_parser_tests, segments_wrapped_around_a_ring_buffer) {
+  auto ring = std::string_view("ple.com:8080/a/b?q=1#fhttps://exam");
+  auto split = ring.find("https");
+  auto segments = {ring.substr(split), ring.substr(0, split)};
+  auto instance = skyr::parse_segments(segments);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("https", instance.value().scheme);
+  EXPECT_EQ("example.com", instance.value().host.value());
+  EXPECT_EQ(8080, instance.value().port.value());
+  ASSERT_EQ(2, instance.value().path.size());
+  EXPECT_EQ("q=1", instance.value().query.value());
+  EXPECT_EQ("f", instance.value().fragment.value());
+}
+
+TEST(url_stream_parser_tests, segments_with_empty_segments) {
+  auto segments = std::vector<std::string_view>{"", "http://example.com/", ""};
+  auto instance = skyr::parse_segments(segments.begin(), segments.end());
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("example.com", instance.value().host.value());
+
+  segments.clear();
+  EXPECT_FALSE(skyr::parse_segments(segments));
+}
+
+TEST(url_stream_parser_tests, long_segments) {
+  auto input = "http://example.com/" + std::string(4096, 'a') + "?" + std::string(4096, 'b');
+  auto view = std::string_view(input);
+  auto segments = std::vector<std::string_view>{
+      view.substr(0, 10), view.substr(10, 3000), view.substr(3010)};
+  auto instance = skyr::parse_segments(segments);
+  ASSERT_TRUE(instance);
+  EXPECT_EQ("example.com", instance.value().host.value());
+  ASSERT_EQ(1, instance.value().path.size());
+  EXPECT_EQ(4096, instance.value().path[0].size());
+  EXPECT_EQ(4096, instance.value().query.value().size());
+}
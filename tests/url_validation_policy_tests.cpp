@@ -0,0 +1,131 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <skyr/url_parse.hpp>
+#include <skyr/url_serialize.hpp>
+#include <skyr/url_validation_policy.hpp>
+#include "test_data.hpp"
+
+namespace {
+struct test_input {
+  std::string input;
+  skyr::optional<skyr::url_record> base;
+};
+
+std::vector<test_input> load_inputs() {
+  auto inputs = std::vector<test_input>{};
+  for (auto &&test : test_data::load_test_data()) {
+    auto input = test_input{test.input, skyr::nullopt};
+    auto base = skyr::parse(test.base);
+    if (base) {
+      input.base = std::move(base.value());
+    }
+    inputs.push_back(std::move(input));
+  }
+  return inputs;
+}
+
+std::vector<skyr::url_validation_errc> codes(const skyr::collect_validation_errors &policy) {
+  auto result = std::vector<skyr::url_validation_errc>{};
+  for (auto &&error : policy.errors()) {
+    result.push_back(error.code);
+  }
+  return result;
+}
+}  // namespace
+
+// Every policy gives the same result as the default policy on the
+// web platform test data, apart from the validation errors
+TEST(url_validation_policy_tests, policies_agree_with_parse) {
+  auto count = 0;
+  for (auto &&test : load_inputs()) {
+    auto expected = skyr::parse(test.input, test.base);
+
+    auto ignored = skyr::parse(test.input, skyr::ignore_validation_errors{}, test.base);
+    ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(ignored)) << test.input;
+
+    auto collected = skyr::collect_validation_errors{};
+    auto collecting = skyr::parse(test.input, collected, test.base);
+    ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(collecting)) << test.input;
+
+    auto strict = skyr::parse(test.input, skyr::fail_on_validation_error{}, test.base);
+
+    if (expected) {
+      EXPECT_EQ(skyr::serialize(expected.value()), skyr::serialize(ignored.value())) << test.input;
+      EXPECT_FALSE(ignored.value().validation_error) << test.input;
+
+      EXPECT_EQ(skyr::serialize(expected.value()), skyr::serialize(collecting.value())) << test.input;
+      EXPECT_EQ(expected.value().validation_error, collecting.value().validation_error) << test.input;
+      EXPECT_EQ(expected.value().validation_error, !collected.errors().empty()) << test.input;
+
+      EXPECT_EQ(!expected.value().validation_error, static_cast<bool>(strict)) << test.input;
+      if (!strict) {
+        EXPECT_EQ(collected.errors().front().code, strict.error()) << test.input;
+      }
+    }
+    else {
+      EXPECT_EQ(expected.error(), ignored.error()) << test.input;
+      EXPECT_EQ(expected.error(), collecting.error()) << test.input;
+      EXPECT_FALSE(strict) << test.input;
+    }
+    ++count;
+  }
+  EXPECT_GT(count, 0);
+}
+
+TEST(url_validation_policy_tests, ignore_validation_errors) {
+  auto instance = skyr::parse("  http://example.com/a b  ", skyr::ignore_validation_errors{});
+  ASSERT_TRUE(instance);
+  EXPECT_FALSE(instance.value().validation_error);
+  EXPECT_EQ("http://example.com/a%20b", skyr::serialize(instance.value()));
+}
+
+TEST(url_validation_policy_tests, fail_on_validation_error) {
+  auto instance = skyr::parse("http://example.com/a b", skyr::fail_on_validation_error{});
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::url_validation_errc::invalid_url_unit, instance.error());
+
+  instance = skyr::parse(" http://example.com/", skyr::fail_on_validation_error{});
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::url_validation_errc::leading_or_trailing_c0_control_or_space, instance.error());
+
+  instance = skyr::parse("http://user@example.com/", skyr::fail_on_validation_error{});
+  ASSERT_FALSE(instance);
+  EXPECT_EQ(skyr::url_validation_errc::invalid_credentials, instance.error());
+
+  instance = skyr::parse("http://example.com/a%20b?q#f", skyr::fail_on_validation_error{});
+  ASSERT_TRUE(instance);
+}
+
+TEST(url_validation_policy_tests, collect_validation_errors) {
+  auto policy = skyr::collect_validation_errors{};
+  auto instance = skyr::parse(" http://ex\tample.com\\a b", policy);
+  ASSERT_TRUE(instance);
+  EXPECT_TRUE(instance.value().validation_error);
+  ASSERT_EQ(
+      (std::vector<skyr::url_validation_errc>{
+        skyr::url_validation_errc::leading_or_trailing_c0_control_or_space,
+        skyr::url_validation_errc::tab_or_newline,
+        skyr::url_validation_errc::invalid_reverse_solidus,
+        skyr::url_validation_errc::invalid_url_unit,
+      }),
+      codes(policy));
+  EXPECT_EQ(0, policy.errors()[0].offset);
+  EXPECT_EQ(9, policy.errors()[1].offset);
+  EXPECT_EQ(18, policy.errors()[2].offset);
+  EXPECT_EQ(20, policy.errors()[3].offset);
+}
+
+TEST(url_validation_policy_tests, collect_validation_errors_is_reset) {
+  auto policy = skyr::collect_validation_errors{};
+  ASSERT_TRUE(skyr::parse("http://example.com/a b", policy));
+  EXPECT_EQ(1, policy.errors().size());
+
+  ASSERT_TRUE(skyr::parse("http://example.com/a", policy));
+  EXPECT_TRUE(policy.errors().empty());
+}
@@ -0,0 +1,161 @@
+// Copyright 2018 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <skyr/url_view.hpp>
+#include <skyr/url_parse.hpp>
+#include <skyr/url.hpp>
+#include "allocation_counter.hpp"
+#include "test_data.hpp"
+
+namespace {
+using test_data::test_input;
+
+std::vector<test_input> load_test_data() {
+  return test_data::load_test_data({
+    {"http://example.com/", ""},
+    {"http://example.com", ""},
+    {"http://example.com:80/", ""},
+    {"http://example.com:0080/", ""},
+    {"https://example.com:8443/a/b?q=1#f", ""},
+    {"http://example.com/a;b", ""},
+    {"http://example.com/a/../b", ""},
+    {"HTTP://EXAMPLE.COM/", ""},
+  });
+}
+
+bool is_inside(std::string_view component, std::string_view buffer) {
+  return (component.data() >= buffer.data()) &&
+         (component.data() + component.size() <= buffer.data() + buffer.size());
+}
+}  // namespace
+
+class test_url_view : public ::testing::TestWithParam<test_input> {};
+
+INSTANTIATE_TEST_CASE_P(url_view_tests, test_url_view,
+                        testing::ValuesIn(load_test_data()));
+
+TEST_P(test_url_view, same_components_as_url) {
+  auto test_input = GetParam();
+
+  auto base = skyr::optional<skyr::url_record>{};
+  if (!test_input.base.empty()) {
+    auto base_url = skyr::parse(test_input.base);
+    if (base_url) {
+      base = base_url.value();
+    }
+  }
+
+  auto expected = skyr::parse(test_input.input, base);
+  auto instance = skyr::make_url_view(test_input.input, base);
+  ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(instance)) << test_input;
+  if (!expected) {
+    return;
+  }
+
+  auto url = skyr::url(skyr::url_record(expected.value()));
+  const auto &view = instance.value();
+  EXPECT_EQ(url.href(), view.href()) << test_input;
+  EXPECT_EQ(url.pathname(), view.pathname()) << test_input;
+  EXPECT_EQ(url.search(), view.search()) << test_input;
+  EXPECT_EQ(url.hash(), view.hash()) << test_input;
+  EXPECT_EQ(view.borrows_input(), url.href() == test_input.input) << test_input;
+  if (view.borrows_input()) {
+    EXPECT_EQ(test_input.input.data(), view.href().data()) << test_input;
+  }
+
+  auto record = view.to_record();
+  EXPECT_EQ(expected.value().scheme, record.scheme) << test_input;
+  EXPECT_EQ(expected.value().username, record.username) << test_input;
+  EXPECT_EQ(expected.value().password, record.password) << test_input;
+  EXPECT_EQ(expected.value().host, record.host) << test_input;
+  EXPECT_EQ(expected.value().port, record.port) << test_input;
+  EXPECT_EQ(expected.value().path, record.path) << test_input;
+  EXPECT_EQ(expected.value().query, record.query) << test_input;
+  EXPECT_EQ(expected.value().fragment, record.fragment) << test_input;
+  EXPECT_EQ(expected.value().cannot_be_a_base_url, record.cannot_be_a_base_url) << test_input;
+  EXPECT_EQ(expected.value().validation_error, record.validation_error) << test_input;
+}
+
+TEST(url_view_tests, borrows_canonical_url) {
+  auto buffer = std::string("https://example.com:8443/a/b?q=1#f");
+  auto instance = skyr::make_url_view(buffer);
+  ASSERT_TRUE(instance);
+  const auto &view = instance.value();
+  EXPECT_TRUE(view.borrows_input());
+  EXPECT_EQ("https", view.scheme());
+  EXPECT_EQ("example.com", view.host().value());
+  EXPECT_EQ(8443, view.port().value());
+  EXPECT_EQ("/a/b", view.pathname());
+  EXPECT_EQ("q=1", view.query().value());
+  EXPECT_EQ("f", view.fragment().value());
+  EXPECT_TRUE(is_inside(view.host().value(), buffer));
+  EXPECT_TRUE(is_inside(view.query().value(), buffer));
+}
+
+TEST(url_view_tests, borrows_canonical_url_from_state_machine) {
+  auto buffer = std::string("mailto:user@example.com");
+  auto instance = skyr::make_url_view(buffer);
+  ASSERT_TRUE(instance);
+  EXPECT_TRUE(instance.value().borrows_input());
+  EXPECT_TRUE(is_inside(instance.value().pathname(), buffer));
+}
+
+TEST(url_view_tests, state_machine_borrows_without_allocating) {
+  auto inputs = std::vector<std::string>{
+    "mailto:user@example.com",
+    "file:///C:/dir/file.txt",
+    "http://127.0.0.1:8080/a/b?q#f",
+    "ftp://ftp.example.com/pub/",
+  };
+  // Initializes the library's lookup tables
+  ASSERT_TRUE(skyr::make_url_view(inputs.front()));
+
+  for (const auto &input : inputs) {
+    allocation_counter::start();
+    auto instance = skyr::make_url_view(input);
+    EXPECT_EQ(0, allocation_counter::stop()) << input;
+    ASSERT_TRUE(instance) << input;
+    EXPECT_TRUE(instance.value().borrows_input()) << input;
+  }
+}
+
+TEST(url_view_tests, copies_url_with_default_port) {
+  auto instance = skyr::make_url_view("http://example.com:80/");
+  ASSERT_TRUE(instance);
+  EXPECT_FALSE(instance.value().borrows_input());
+  EXPECT_EQ("http://example.com/", instance.value().href());
+  EXPECT_FALSE(instance.value().port());
+}
+
+TEST(url_view_tests, copies_url_without_path) {
+  auto instance = skyr::make_url_view("http://example.com?q");
+  ASSERT_TRUE(instance);
+  EXPECT_FALSE(instance.value().borrows_input());
+  EXPECT_EQ("http://example.com/?q", instance.value().href());
+}
+
+TEST(url_view_tests, copies_url_with_dot_segments) {
+  auto instance = skyr::make_url_view("http://example.com/a/../b");
+  ASSERT_TRUE(instance);
+  EXPECT_FALSE(instance.value().borrows_input());
+  EXPECT_EQ("/b", instance.value().pathname());
+}
+
+TEST(url_view_tests, copy_of_owned_view_refers_to_its_own_buffer) {
+  auto instance = skyr::make_url_view("http://EXAMPLE.com/?q#f");
+  ASSERT_TRUE(instance);
+  auto copy = instance.value();
+  EXPECT_FALSE(copy.borrows_input());
+  EXPECT_EQ("example.com", copy.host().value());
+  EXPECT_TRUE(is_inside(copy.host().value(), copy.href()));
+  EXPECT_NE(instance.value().href().data(), copy.href().data());
+}
+
+TEST(url_view_tests, invalid_url) {
+  EXPECT_FALSE(skyr::make_url_view("http://exa mple.com/"));
+}